@@ -33,7 +33,7 @@ const int pinLED   = 13;
 
 const long DEFAULT_RS232_RATE = 115200L;
 
-const char *APP_VER = "2.00";
+const char *APP_VER = "2.30";
 ////////////////////////////////////////////////////////////////////////////////
 const byte CMD_RESET  = 0x74; //ASCII for t
 const byte CMD_STATUS = 0x3F; //ASCII for ?
@@ -41,6 +41,13 @@ const byte CMD_GETVER = 0x61; //ASCII for a
 const byte CMD_SEND   = 0x73; //ASCII for s
 const byte CMD_READ   = 0x72; //ASCII for r
 const byte CMD_FORCE  = 0x66; //ASCII for f
+const byte CMD_SHIFT  = 0x78; //ASCII for x
+const byte CMD_STREAM = 0x71; //ASCII for q
+const byte CMD_SYNC   = 0x79; //ASCII for y
+const byte CMD_BAUD   = 0x62; //ASCII for b
+const byte CMD_DELAY  = 0x64; //ASCII for d
+
+const unsigned int SHIFT_NO_TDO = 0x8000;
 
 const int STATUS_OK   = 0x6F6B; //ASCII for ok
 const int STATUS_ERR1 = 0x6531; //ASCII for e1
@@ -56,55 +63,75 @@ const byte MASK_GP2  = 0x40;
 const byte MASK_GP3  = 0x80;
 
 int status;
+int batchStatus;
+boolean streaming;
+long newRate;              // UART rate to switch to after the status
+unsigned int tckDelay;     // TCK half period in us, 0 = full speed
 ////////////////////////////////////////////////////////////////////////////////
 /*
 Wapper functions for clear/set individual pins.
-Just in case it needs to be replaced with direct pins access
+All JTAG pins are on PORTD, digitalWrite/digitalRead are far too slow
+for bit banging so the port registers are accessed directly.
 */
+#define BIT_GP0   (1 << pinGP0)
+#define BIT_TMS0  (1 << pinTMS0)
+#define BIT_TCK0  (1 << pinTCK0)
+#define BIT_TDI0  (1 << pinTDI0)
+#define BIT_TRST0 (1 << pinTRST0)
+#define BIT_TDO0  (1 << pinTDO0)
+
 inline void setGP0() {
-  digitalWrite(pinGP0, HIGH);
+  PORTD |= BIT_GP0;
 }
 
 inline void clrGP0() {
-  digitalWrite(pinGP0, LOW);
+  PORTD &= ~BIT_GP0;
 }
 
 inline void setTRST0() {
-  digitalWrite(pinTRST0, HIGH);
+  PORTD |= BIT_TRST0;
 }
 
 inline void clrTRST0() {
-  digitalWrite(pinTRST0, LOW);
+  PORTD &= ~BIT_TRST0;
 }
 
 inline void setTMS0() {
-  digitalWrite(pinTMS0, HIGH);
+  PORTD |= BIT_TMS0;
 }
 
 inline void clrTMS0() {
-  digitalWrite(pinTMS0, LOW);
+  PORTD &= ~BIT_TMS0;
 }
 
 inline void setTCK0() {
-  digitalWrite(pinTCK0, HIGH);
+  PORTD |= BIT_TCK0;
 }
 
 inline void clrTCK0() {
-  digitalWrite(pinTCK0, LOW);
+  PORTD &= ~BIT_TCK0;
 }
 
 inline void toggleTCK0() {
   //assume it is LOW by default
-  digitalWrite(pinTCK0, HIGH);
-  digitalWrite(pinTCK0, LOW);
+  PORTD |= BIT_TCK0;
+  if(tckDelay)
+    delayMicroseconds(tckDelay);
+  PORTD &= ~BIT_TCK0;
+  if(tckDelay)
+    delayMicroseconds(tckDelay);
 }
 
 inline void setTDI0() {
-  digitalWrite(pinTDI0, HIGH);
+  PORTD |= BIT_TDI0;
 }
 
 inline void clrTDI0() {
-  digitalWrite(pinTDI0, LOW);
+  PORTD &= ~BIT_TDI0;
+}
+
+inline boolean readTDO0() {
+  return (PIND & BIT_TDO0) != 0;
 }
 ////////////////////////////////////////////////////////////////////////////////
 void setup() {
@@ -125,6 +152,10 @@ void setup() {
 
   Serial.begin(DEFAULT_RS232_RATE);
   status = STATUS_OK;
+  batchStatus = STATUS_OK;
+  streaming = false;
+  newRate = 0;
+  tckDelay = 0;
 }
 ////////////////////////////////////////////////////////////////////////////////
 void loop() {
@@ -175,7 +206,7 @@ void loop() {
         //Serial.println("CMD_READ");
         byte tmp;
 
-        if(digitalRead(pinTDO0) == HIGH) {
+        if(readTDO0()) {
           tmp = 0x31;
         }
         else {
@@ -215,6 +246,82 @@ void loop() {
         status = STATUS_OK;
         break;
       }
+      case CMD_SHIFT: {
+        //Serial.println("CMD_SHIFT");
+        unsigned int nBits;
+        boolean sendTdo;
+        byte tdi, tdo, bit;
+
+        while(Serial.available() == 0);
+        nBits = (unsigned int)Serial.read() << 8;
+        while(Serial.available() == 0);
+        nBits |= (byte)Serial.read();
+        sendTdo = !(nBits & SHIFT_NO_TDO);
+        nBits &= ~SHIFT_NO_TDO;
+
+        clrTMS0();
+        while(nBits > 0) {
+          while(Serial.available() == 0);
+          tdi = (byte)Serial.read();
+          tdo = 0;
+
+          for(bit = 0; bit < 8 && nBits > 0; bit++, nBits--) {
+            if(tdi & (1 << bit))
+              setTDI0();
+            else
+              clrTDI0();
+            if(readTDO0())
+              tdo |= (1 << bit);
+            toggleTCK0();
+          }
+          if(sendTdo)
+            Serial.write(tdo);
+        }
+        status = STATUS_OK;
+        break;
+      }
+      case CMD_STREAM: {
+        //Serial.println("CMD_STREAM");
+        streaming = true;
+        batchStatus = STATUS_OK;
+        status = STATUS_OK;
+        break;
+      }
+      case CMD_SYNC: {
+        //Serial.println("CMD_SYNC");
+        streaming = false;
+        status = batchStatus;
+        batchStatus = STATUS_OK;
+        break;
+      }
+      case CMD_BAUD: {
+        //Serial.println("CMD_BAUD");
+        long rate = 0;
+        byte i;
+
+        for(i = 0; i < 4; i++) {
+          while(Serial.available() == 0);
+          rate = (rate << 8) | (byte)Serial.read();
+        }
+        // the status still goes out at the old rate
+        if(rate > 0) {
+          newRate = rate;
+          status = STATUS_OK;
+        }
+        else {
+          status = STATUS_ERR2;
+        }
+        break;
+      }
+      case CMD_DELAY: {
+        //Serial.println("CMD_DELAY");
+        while(Serial.available() == 0);
+        tckDelay = (unsigned int)Serial.read() << 8;
+        while(Serial.available() == 0);
+        tckDelay |= (byte)Serial.read();
+        status = STATUS_OK;
+        break;
+      }
       case CMD_GETVER: {
         //Serial.println("CMD_GETVER");
         Serial.print(APP_VER);
@@ -231,9 +338,20 @@ void loop() {
         break;
       }
     }
-    Serial.write(highByte(status));
-    Serial.write(lowByte(status));
-    Serial.flush();
+    if(streaming) {
+      // no status in a batch, keep the first error for CMD_SYNC
+      if(status != STATUS_OK && batchStatus == STATUS_OK)
+        batchStatus = status;
+    }
+    else {
+      Serial.write(highByte(status));
+      Serial.write(lowByte(status));
+      Serial.flush();
+      if(newRate) {
+        Serial.begin(newRate);
+        newRate = 0;
+      }
+    }
   }
 }
 ////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
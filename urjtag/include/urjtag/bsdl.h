@@ -33,6 +33,7 @@ typedef struct
 {
     char **path_list;
     int debug;
+    char *cache_file;
 }
 urj_bsdl_globs_t;
 
@@ -40,6 +41,7 @@ urj_bsdl_globs_t;
     do { \
         bsdl.path_list = NULL; \
         bsdl.debug = 0; \
+        bsdl.cache_file = NULL; \
     } while (0)
 
 /* @@@@ RFHH ToDo: let urj_bsdl_read_file also return URJ_STATUS_... */
@@ -59,5 +61,13 @@ void urj_bsdl_set_path (urj_chain_t *, const char *);
  *   > 0 : No errors, idcode checked and matched
  */
 int urj_bsdl_scan_files (urj_chain_t *, const char *, int);
+/**
+ * Cache the IDCODE pattern and the resulting commands of the BSDL files
+ * scanned by urj_bsdl_scan_files() in file, NULL disables the cache.
+ * Entries are refreshed when a file's modification time or size changes.
+ *
+ * @return URJ_STATUS_OK, URJ_STATUS_FAIL
+ */
+int urj_bsdl_set_cache (urj_chain_t *, const char *);
 
 #endif /* URJ_BSDL_BSDL_H */
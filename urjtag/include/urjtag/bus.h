@@ -38,6 +38,23 @@ int urj_bus_readmem (urj_bus_t *bus, FILE *f, uint32_t addr, uint32_t len);
 /** @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on error */
 int urj_bus_writemem (urj_bus_t *bus, FILE *f, uint32_t addr, uint32_t len);
 
+/**
+ * Read count words at addr, addr + step, ... with the driver's read_block,
+ * or with read_start/read_next/read_end if it has none.
+ *
+ * @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on error
+ */
+int urj_bus_read_block (urj_bus_t *bus, uint32_t addr, uint32_t step,
+                        uint32_t *data, uint32_t count);
+/**
+ * Write count words at addr, addr + step, ... with the driver's write_block,
+ * or word by word if it has none.
+ *
+ * @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on error
+ */
+int urj_bus_write_block (urj_bus_t *bus, uint32_t addr, uint32_t step,
+                         const uint32_t *data, uint32_t count);
+
 typedef struct
 {
     int len;
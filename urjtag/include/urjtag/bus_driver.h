@@ -121,6 +121,14 @@ struct URJ_BUS_DRIVER
     int (*enable) (urj_bus_t *bus);
     int (*disable) (urj_bus_t *bus);
     urj_bus_type_t bus_type;
+    /* optional burst access to count words at adr, adr + step, ...;
+       see urj_bus_read_block() and urj_bus_write_block() */
+    /** @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on error */
+    int (*read_block) (urj_bus_t *bus, uint32_t adr, uint32_t step,
+                       uint32_t *data, uint32_t count);
+    /** @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on error */
+    int (*write_block) (urj_bus_t *bus, uint32_t adr, uint32_t step,
+                        const uint32_t *data, uint32_t count);
 };
 
 struct URJ_BUS
@@ -66,6 +66,9 @@ typedef enum URJ_CABLE_PARAM_KEY
     URJ_CABLE_PARAM_KEY_INTERFACE,      /* lu           ftdi */
     URJ_CABLE_PARAM_KEY_FIRMWARE,       /* string       ice100 */
     URJ_CABLE_PARAM_KEY_INDEX,          /* lu           ftdi */
+    URJ_CABLE_PARAM_KEY_BAUD,           /* lu           arduiggler */
+    URJ_CABLE_PARAM_KEY_ASYNC,          /* lu           ftdi */
+    URJ_CABLE_PARAM_KEY_THREAD,         /* lu           ft2232 */
 }
 urj_cable_param_key_t;
 
@@ -139,12 +142,14 @@ struct URJ_CABLE_QUEUE
             int len;
             char *in;
             char *out;
+            int borrowed;       /* in/out not malloc'ed, don't free */
         } transfer;
         struct
         {
             int len;
             int res;
             char *out;
+            int borrowed;       /* out not malloc'ed, don't free */
         } xferred;
     } arg;
 };
@@ -160,6 +165,9 @@ struct URJ_CABLE_QUEUE_INFO
     int next_free;
 };
 
+/* slab of transfer payload memory, private to cable.c */
+typedef struct URJ_CABLE_ARENA urj_cable_arena_t;
+
 struct URJ_CABLE
 {
     const urj_cable_driver_t *driver;
@@ -173,6 +181,8 @@ struct URJ_CABLE
     urj_chain_t *chain;
     urj_cable_queue_info_t todo;
     urj_cable_queue_info_t done;
+    urj_cable_arena_t *arena;   /* buffers of deferred transfers */
+    int pending;                /* todo batches still owned by a driver thread */
     uint32_t delay;
     uint32_t frequency;
 };
@@ -211,6 +221,16 @@ int urj_tap_cable_transfer_late (urj_cable_t *cable, char *out);
 /** @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on failure */
 int urj_tap_cable_defer_transfer (urj_cable_t *cable, int len, char *in,
                                   char *out);
+/**
+ * Like urj_tap_cable_defer_transfer(), but the queue keeps @in and @out
+ * instead of copies: the caller must leave both untouched until the
+ * result was collected with urj_tap_cable_transfer_late() or the queue
+ * has been flushed completely.
+ *
+ * @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on failure
+ */
+int urj_tap_cable_defer_transfer_nocopy (urj_cable_t *cable, int len,
+                                         char *in, char *out);
 
 void urj_tap_cable_set_frequency (urj_cable_t *cable, uint32_t frequency);
 uint32_t urj_tap_cable_get_frequency (urj_cable_t *cable);
@@ -36,6 +36,9 @@
 #define URJ_CHAIN_EXITMODE_EXIT1        2
 #define URJ_CHAIN_EXITMODE_UPDATE       3
 
+/** recorded data register shifts of a burst, private to chain.c */
+typedef struct URJ_CHAIN_BURST urj_chain_burst_t;
+
 struct URJ_CHAIN
 {
     int state;
@@ -45,6 +48,7 @@ struct URJ_CHAIN
     urj_cable_t *cable;
     urj_bsdl_globs_t bsdl;
     int main_part;
+    urj_chain_burst_t *burst;
 };
 
 urj_chain_t *urj_tap_chain_alloc (void);
@@ -82,6 +86,30 @@ int urj_tap_chain_shift_data_registers_mode (urj_chain_t *chain,
                                              int capture_output, int capture,
                                              int chain_exit);
 void urj_tap_chain_flush (urj_chain_t *chain);
+/**
+ * Start recording data register shifts. Until urj_tap_chain_burst_replay(),
+ * urj_tap_chain_shift_data_registers() only queues the shifts on the cable
+ * with copies of the registers; the captured outputs are not available yet.
+ * Instruction shifts are not allowed during a burst.
+ *
+ * @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on error
+ */
+int urj_tap_chain_burst_start (urj_chain_t *chain);
+/**
+ * Flush the recorded shifts and collect their outputs. After this the same
+ * sequence of data register shifts has to be issued again; the shifts do not
+ * access the cable but load the recorded outputs into the data registers.
+ *
+ * @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on error
+ */
+int urj_tap_chain_burst_replay (urj_chain_t *chain);
+/**
+ * End a burst; flushes the cable if it was not replayed.
+ *
+ * @return URJ_STATUS_OK if every shift was recorded and replayed as issued;
+ *      URJ_STATUS_FAIL otherwise
+ */
+int urj_tap_chain_burst_end (urj_chain_t *chain);
 /** @return 0 or 1 on success; -1 on failure */
 int urj_tap_chain_set_pod_signal (urj_chain_t *chain, int mask, int val);
 /** @return 0 or 1 on success; -1 on failure */
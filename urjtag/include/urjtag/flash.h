@@ -73,6 +73,13 @@ void urj_flash_cleanup (void);
 
 /** @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on error */
 int urj_flashmem (urj_bus_t *bus, FILE *f, uint32_t addr, int);
+/**
+ * Like urj_flashmem(), but erase blocks whose part of the image already
+ * matches the flash contents are neither erased nor programmed.
+ *
+ * @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on error
+ */
+int urj_flashmem_diff (urj_bus_t *bus, FILE *f, uint32_t addr, int);
 /** @return URJ_STATUS_OK on success; URJ_STATUS_FAIL on error */
 int urj_flashmsbin (urj_bus_t *bus, FILE *f, int);
 
@@ -72,6 +72,9 @@ struct URJ_JIM_DEVICE
     urj_jim_device_t *prev;
 
     urj_jim_tap_state_t tap_state;
+    /* tck_rise and tck_fall are not called for the TMS=0 clocks that
+       urj_jim_transfer/urj_jim_clock simulate in bulk; they should only
+       act on state changes */
     void (*tck_rise) (urj_jim_device_t *dev, int tms, int tdi,
                       uint8_t *shmem, size_t shmem_size);
     void (*tck_fall) (urj_jim_device_t *dev, uint8_t *shmem,
@@ -125,6 +128,17 @@ int urj_jim_get_trst (urj_jim_state_t *s);
 int urj_jim_get_tdo (urj_jim_state_t *s);
 void urj_jim_tck_rise (urj_jim_state_t *s, int tms, int tdi);
 void urj_jim_tck_fall (urj_jim_state_t *s);
+/**
+ * Clock len bits with TMS=0, TDI from in[]; out[] (if not NULL) receives
+ * the TDO before each clock. In Shift-DR/IR this shifts 32 bits at a time.
+ */
+void urj_jim_transfer (urj_jim_state_t *s, int len, const char *in,
+                       char *out);
+/**
+ * Clock n times with constant tms and tdi. Runs of TMS=0 in a stable
+ * state are not simulated clock by clock.
+ */
+void urj_jim_clock (urj_jim_state_t *s, int tms, int tdi, int n);
 urj_jim_device_t *urj_jim_alloc_device (int num_sregs, const int reg_size[]);
 urj_jim_state_t *urj_jim_init (void);
 void urj_jim_free (urj_jim_state_t *s);
@@ -39,6 +39,14 @@ typedef struct
     void *priv;
 } urj_pld_t;
 
+/**
+ * Receives consecutive chunks of configuration readback data.
+ *
+ * @return URJ_STATUS_OK to continue; URJ_STATUS_FAIL to abort the readback
+ */
+typedef int (*urj_pld_readback_sink_t) (void *data, const uint8_t *buf,
+                                        uint32_t len);
+
 typedef struct
 {
     const char *name;
@@ -49,6 +57,9 @@ typedef struct
     int (*read_register) (urj_pld_t *pld, uint32_t reg, uint32_t *value);
     int (*write_register) (urj_pld_t *pld, uint32_t reg, uint32_t value);
     int register_width;
+    /* stream len bytes of configuration data read back from the device */
+    int (*readback) (urj_pld_t *pld, uint32_t len,
+                     urj_pld_readback_sink_t sink, void *data);
 } urj_pld_driver_t;
 
 /**
@@ -125,4 +136,41 @@ int urj_pld_read_register (urj_chain_t *chain, uint32_t reg);
  */
 int urj_pld_write_register (urj_chain_t *chain, uint32_t reg, uint32_t value);
 
+/**
+ * urj_pld_readback(chain, filename, len)
+ *
+ * Main entry point for the 'pld readback' command.
+ *
+ * Reads len bytes of configuration data back from the device and writes
+ * them to filename as they arrive. The file is only created once the
+ * device is known to support readback, and removed if the readback fails.
+ *
+ * @param chain            pointer to global chain
+ * @param filename         name of the output file
+ * @param len              number of bytes to read back, > 0
+ *
+ * @return
+ *   URJ_STATUS_OK, URJ_STATUS_FAIL
+ */
+int urj_pld_readback (urj_chain_t *chain, const char *filename,
+                      uint32_t len);
+
+/**
+ * urj_pld_verify(chain, ref_file, mask_file)
+ *
+ * Main entry point for the 'pld verify' command.
+ *
+ * Reads back as much configuration data as ref_file holds and compares
+ * it with ref_file while streaming. Bits set in mask_file are not
+ * compared; mask_file may be NULL.
+ *
+ * @param chain            pointer to global chain
+ * @param ref_file         file handle of the expected readback data
+ * @param mask_file        file handle of the mask, or NULL
+ *
+ * @return
+ *   URJ_STATUS_OK if the data matched, URJ_STATUS_FAIL otherwise
+ */
+int urj_pld_verify (urj_chain_t *chain, FILE *ref_file, FILE *mask_file);
+
 #endif /* URJ_PLD_H */
@@ -53,4 +53,63 @@
 int urj_svf_run (urj_chain_t *chain, FILE *SVF_FILE, int stop_on_mismatch,
                  uint32_t ref_freq);
 
+/** default number of TDO checks kept in flight by urj_svf_run_pipelined() */
+#define URJ_SVF_PIPELINE_DEPTH  64
+
+/**
+ * ***************************************************************************
+ * urj_svf_run_pipelined(chain, SVF_FILE, stop_on_mismatch, ref_freq, depth)
+ *
+ * Like urj_svf_run(), but SIR/SDR commands with TDO are not checked
+ * right away. Up to depth checks are queued while the following commands
+ * are shifted, and they are evaluated in order as the results arrive.
+ * Mismatches are still reported with the line of the failing command,
+ * but with stop_on_mismatch up to depth more commands may already have
+ * been shifted when execution stops.
+ *
+ * @param depth            number of outstanding checks, 0 = no pipelining
+ *
+ * @return
+ *   URJ_STATUS_OK, URJ_STATUS_FAIL
+ * ***************************************************************************/
+int urj_svf_run_pipelined (urj_chain_t *chain, FILE *SVF_FILE,
+                           int stop_on_mismatch, uint32_t ref_freq,
+                           int depth);
+
+/**
+ * ***************************************************************************
+ * urj_svf_compile(chain, SVF_FILE, out)
+ *
+ * Translates the SVF commands in SVF_FILE into a compact binary command
+ * stream for the current chain: state paths are resolved to TMS
+ * sequences and SIR/SDR to packed TDI/TDO/MASK vectors of the whole
+ * chain. Nothing is shifted. The result is only valid for a chain with
+ * the same parts and active instructions of the non-SVF parts.
+ *
+ * @param out              file handle the compiled stream is written to
+ *
+ * @return
+ *   URJ_STATUS_OK, URJ_STATUS_FAIL
+ * ***************************************************************************/
+int urj_svf_compile (urj_chain_t *chain, FILE *SVF_FILE, FILE *out);
+
+/**
+ * ***************************************************************************
+ * urj_svf_play(chain, SVF_FILE, stop_on_mismatch, ref_freq)
+ *
+ * Plays a file written by urj_svf_compile(). The file is mapped into
+ * memory and fed to the cable without parsing; TDO checks are evaluated
+ * late, up to URJ_SVF_PIPELINE_DEPTH commands behind.
+ *
+ * @return
+ *   URJ_STATUS_OK, URJ_STATUS_FAIL
+ * ***************************************************************************/
+int urj_svf_play (urj_chain_t *chain, FILE *SVF_FILE, int stop_on_mismatch,
+                  uint32_t ref_freq);
+
+/**
+ * @return 1 if SVF_FILE was written by urj_svf_compile(), 0 otherwise
+ */
+int urj_svf_is_compiled (FILE *SVF_FILE);
+
 #endif /* URJ_SVF_H */
@@ -36,6 +36,15 @@ void urj_tap_capture_ir (urj_chain_t *chain);
 void urj_tap_defer_shift_register (urj_chain_t *chain,
                                    const urj_tap_register_t *in,
                                    urj_tap_register_t *out, int tap_exit);
+/**
+ * Like urj_tap_defer_shift_register(), but the cable queue uses the data
+ * of @in and @out instead of copies. Neither may change until
+ * urj_tap_shift_register_output() has been called or the chain flushed.
+ */
+void urj_tap_defer_shift_register_nocopy (urj_chain_t *chain,
+                                          const urj_tap_register_t *in,
+                                          urj_tap_register_t *out,
+                                          int tap_exit);
 void urj_tap_shift_register_output (urj_chain_t *chain,
                                     const urj_tap_register_t *in,
                                     urj_tap_register_t *out, int tap_exit);
@@ -60,4 +60,47 @@ urj_tap_register_t *urj_tap_register_shift_right (urj_tap_register_t *tr,
 urj_tap_register_t *urj_tap_register_shift_left (urj_tap_register_t *tr,
                                                  int shift);
 
+/*
+ * Packed bit vectors: 64 bits per word, bit n of the vector is bit
+ * (n % 64) of data[n / 64].  Bits above len in the last word are kept 0,
+ * so whole words can be compared and copied.  Use these for long
+ * registers and vectors; the urj_tap_register_t functions above keep one
+ * char per bit for the cable drivers.
+ */
+struct URJ_TAP_PACKED
+{
+    uint64_t *data;     /* (public, r/w) packed data, see above */
+    int len;            /* (public, r/o) length in bits */
+};
+
+#define URJ_TAP_PACKED_WORDS(len)       (((len) + 63) / 64)
+#define URJ_TAP_PACKED_GET_BIT(tp, n) \
+    ((int) (((tp)->data[(n) / 64] >> ((n) % 64)) & 1))
+
+urj_tap_packed_t *urj_tap_packed_alloc (int len);
+void urj_tap_packed_free (urj_tap_packed_t *tp);
+urj_tap_packed_t *urj_tap_packed_fill (urj_tap_packed_t *tp, int val);
+void urj_tap_packed_set_bit (urj_tap_packed_t *tp, int n, int val);
+int urj_tap_packed_set_value (urj_tap_packed_t *tp, uint64_t val);
+uint64_t urj_tap_packed_get_value (const urj_tap_packed_t *tp);
+int urj_tap_packed_compare (const urj_tap_packed_t *tp,
+                            const urj_tap_packed_t *tp2);
+/** @return 0 when tp and tp2 agree in all bits set in mask */
+int urj_tap_packed_compare_masked (const urj_tap_packed_t *tp,
+                                   const urj_tap_packed_t *tp2,
+                                   const urj_tap_packed_t *mask);
+urj_tap_packed_t *urj_tap_packed_inc (urj_tap_packed_t *tp);
+urj_tap_packed_t *urj_tap_packed_shift_right (urj_tap_packed_t *tp,
+                                              int shift);
+urj_tap_packed_t *urj_tap_packed_shift_left (urj_tap_packed_t *tp,
+                                             int shift);
+
+/* conversion shims for code working on char per bit arrays */
+void urj_tap_packed_from_bits (urj_tap_packed_t *tp, const char *bits);
+void urj_tap_packed_to_bits (const urj_tap_packed_t *tp, char *bits);
+int urj_tap_packed_from_register (urj_tap_packed_t *tp,
+                                  const urj_tap_register_t *tr);
+int urj_tap_register_from_packed (urj_tap_register_t *tr,
+                                  const urj_tap_packed_t *tp);
+
 #endif /* URJ_REGISTER_H */
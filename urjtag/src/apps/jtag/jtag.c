@@ -52,6 +52,7 @@
 #include <urjtag/cmd.h>
 #include <urjtag/flash.h>
 #include <urjtag/parse.h>
+#include <urjtag/bsdl.h>
 #include <urjtag/jtag.h>
 
 static int urj_interactive = 0;
@@ -59,6 +60,7 @@ static int urj_interactive = 0;
 #define JTAGDIR         ".jtag"
 #define HISTORYFILE     "history"
 #define RCFILE          "rc"
+#define BSDLCACHEFILE   "bsdl_cache"
 
 static char *
 jtag_get_jtagdir (const char *subpath)
@@ -539,6 +541,19 @@ main (int argc, char *const argv[])
     /* Create ~/.jtag */
     if (jtag_create_jtagdir () != URJ_STATUS_OK)
         urj_log_error_describe (URJ_LOG_LEVEL_WARNING);
+#ifdef ENABLE_BSDL
+    else
+    {
+        /* Cache processed BSDL files, the RC file may override this */
+        char *cache = jtag_get_jtagdir (BSDLCACHEFILE);
+
+        if (cache)
+        {
+            urj_bsdl_set_cache (chain, cache);
+            free (cache);
+        }
+    }
+#endif
 
     /* Parse and execute the RC file */
     if (!norc)
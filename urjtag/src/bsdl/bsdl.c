@@ -36,6 +36,7 @@
 #include <urjtag/chain.h>
 #include <urjtag/part.h>
 #include <urjtag/cmd.h>
+#include <urjtag/bsdl.h>
 
 //#include "bsdl_local.h"
 #include "bsdl_types.h"
@@ -50,25 +51,16 @@
 
 
 /*****************************************************************************
- * urj_bsdl_read_file( chain, BSDL_File_Name, proc_mode, idcode )
- *
- * Read, parse and optionally apply contents of BSDL file.
+ * bsdl_read_file( chain, BSDL_File_Name, proc_mode, idcode, cache )
  *
- * Parameters
- *   chain     : pointer to active chain structure
- *   BSDL_File_Name : name of BSDL file to read
- *   proc_mode : processing mode, consisting of BSDL_MODE_* bits
- *   idcode    : reference idcode string
- *
- * Returns
- *   < 0 : Error occured, parse/syntax problems or out of memory
- *   = 0 : No errors, idcode not checked or mismatching
- *   > 0 : No errors, idcode checked and matched
+ * Like urj_bsdl_read_file(), additionally fills in the IDCODE pattern and
+ * the generated commands of the file if cache is not NULL.
  *
  ****************************************************************************/
-int
-urj_bsdl_read_file (urj_chain_t *chain, const char *BSDL_File_Name,
-                    int proc_mode, const char *idcode)
+static int
+bsdl_read_file (urj_chain_t *chain, const char *BSDL_File_Name,
+                int proc_mode, const char *idcode,
+                urj_bsdl_cache_entry_t *cache)
 {
     urj_bsdl_globs_t *globs = &(chain->bsdl);
     FILE *BSDL_File;
@@ -84,6 +76,7 @@ urj_bsdl_read_file (urj_chain_t *chain, const char *BSDL_File_Name,
         proc_mode |= URJ_BSDL_MODE_MSG_ALL;
 
     jtag_ctrl.proc_mode = proc_mode;
+    jtag_ctrl.cache = cache;
 
     /* perform some basic checks */
     if (proc_mode & URJ_BSDL_MODE_INSTR_EXEC)
@@ -121,6 +114,8 @@ urj_bsdl_read_file (urj_chain_t *chain, const char *BSDL_File_Name,
         urj_bsdl_err_set (proc_mode, URJ_ERROR_IO,
                           "Unable to open BSDL file '%s'",
                           BSDL_File_Name);
+        if (cache)
+            cache->broken = 1;
         return -1;
     }
 
@@ -151,6 +146,8 @@ urj_bsdl_read_file (urj_chain_t *chain, const char *BSDL_File_Name,
             urj_bsdl_err (proc_mode,
                           _("BSDL file '%s' contains errors in VHDL stage, stopping\n"),
                           BSDL_File_Name);
+            if (cache)
+                cache->broken = 1;
         }
 
 
@@ -161,6 +158,117 @@ urj_bsdl_read_file (urj_chain_t *chain, const char *BSDL_File_Name,
 }
 
 
+/*****************************************************************************
+ * urj_bsdl_read_file( chain, BSDL_File_Name, proc_mode, idcode )
+ *
+ * Read, parse and optionally apply contents of BSDL file.
+ *
+ * Parameters
+ *   chain     : pointer to active chain structure
+ *   BSDL_File_Name : name of BSDL file to read
+ *   proc_mode : processing mode, consisting of BSDL_MODE_* bits
+ *   idcode    : reference idcode string
+ *
+ * Returns
+ *   < 0 : Error occured, parse/syntax problems or out of memory
+ *   = 0 : No errors, idcode not checked or mismatching
+ *   > 0 : No errors, idcode checked and matched
+ *
+ ****************************************************************************/
+int
+urj_bsdl_read_file (urj_chain_t *chain, const char *BSDL_File_Name,
+                    int proc_mode, const char *idcode)
+{
+    return bsdl_read_file (chain, BSDL_File_Name, proc_mode, idcode, NULL);
+}
+
+
+/*****************************************************************************
+ * void urj_bsdl_set_cache( chain, file )
+ *
+ * Sets the file that caches processed BSDL files for urj_bsdl_scan_files().
+ *
+ * Parameters
+ *   chain : pointer to active chain structure
+ *   file  : name of the cache file, NULL disables the cache
+ *
+ * Returns
+ *   URJ_STATUS_OK, URJ_STATUS_FAIL
+ ****************************************************************************/
+int
+urj_bsdl_set_cache (urj_chain_t *chain, const char *file)
+{
+    urj_bsdl_globs_t *globs = &(chain->bsdl);
+    char *cache_file = NULL;
+
+    if (file && (cache_file = strdup (file)) == NULL)
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "strdup(%s) fails", file);
+        return URJ_STATUS_FAIL;
+    }
+
+    free (globs->cache_file);
+    globs->cache_file = cache_file;
+
+    return URJ_STATUS_OK;
+}
+
+
+/*****************************************************************************
+ * bsdl_scan_file( chain, name, st, idcode, proc_mode, cache )
+ *
+ * Checks a single file for urj_bsdl_scan_files(), through the cache if
+ * there is one.
+ ****************************************************************************/
+static int
+bsdl_scan_file (urj_chain_t *chain, const char *name, const struct stat *st,
+                const char *idcode, int proc_mode, urj_bsdl_cache_t *cache)
+{
+    urj_bsdl_cache_entry_t *e;
+    int result;
+
+    if (cache == NULL)
+        return bsdl_read_file (chain, name, proc_mode, idcode, NULL);
+
+    e = urj_bsdl_cache_lookup (cache, name, st->st_mtime, st->st_size);
+    if (e != NULL)
+    {
+        /* files that don't match are not parsed at all */
+        if (!urj_bsdl_cache_match (e, idcode))
+            return 0;
+        if (e->cmds != NULL)
+        {
+            urj_bsdl_msg (proc_mode, _("Using cached BSDL file '%s'\n"),
+                          name);
+            return urj_bsdl_cache_apply (chain, e, proc_mode);
+        }
+    }
+
+    /* parse and remember what the file contains */
+    if ((e = urj_bsdl_cache_update (cache, name, st->st_mtime, st->st_size))
+        == NULL)
+        return bsdl_read_file (chain, name, proc_mode, idcode, NULL);
+
+    result = bsdl_read_file (chain, name, proc_mode, idcode, e);
+
+    if (e->broken)
+    {
+        /* try again once the file changes */
+        free (e->idcode);
+        e->idcode = NULL;
+    }
+    if (result <= 0)
+    {
+        /* commands are only complete for a file that was applied */
+        free (e->cmds);
+        e->cmds = NULL;
+        e->cmds_len = e->cmds_size = 0;
+    }
+
+    return result;
+}
+
+
 /*****************************************************************************
  * void urj_bsdl_set_path( chain, pathlist )
  *
@@ -252,6 +360,7 @@ int
 urj_bsdl_scan_files (urj_chain_t *chain, const char *idcode, int proc_mode)
 {
     urj_bsdl_globs_t *globs = &(chain->bsdl);
+    urj_bsdl_cache_t *cache = NULL;
     int idx = 0;
     int result = 0;
 
@@ -259,6 +368,11 @@ urj_bsdl_scan_files (urj_chain_t *chain, const char *idcode, int proc_mode)
     if (globs->path_list == NULL)
         return 0;
 
+    /* the cache only knows files by their IDCODE */
+    if (globs->cache_file && idcode
+        && (proc_mode & URJ_BSDL_MODE_IDCODE_CHECK))
+        cache = urj_bsdl_cache_load (globs->cache_file);
+
     while (globs->path_list[idx] && (result <= 0))
     {
         DIR *dir;
@@ -287,8 +401,8 @@ urj_bsdl_scan_files (urj_chain_t *chain, const char *idcode, int proc_mode)
                     {
                         if (buf.st_mode & S_IFREG)
                         {
-                            result = urj_bsdl_read_file (chain, name, proc_mode,
-                                                         idcode);
+                            result = bsdl_scan_file (chain, name, &buf, idcode,
+                                                     proc_mode, cache);
                             if (result == 1)
                                 printf (_("  Filename:     %s\n"), name);
                         }
@@ -308,6 +422,16 @@ urj_bsdl_scan_files (urj_chain_t *chain, const char *idcode, int proc_mode)
         idx++;
     }
 
+    if (cache)
+    {
+        if (urj_bsdl_cache_save (cache, globs->cache_file) != URJ_STATUS_OK)
+        {
+            urj_warning ("%s\n", urj_error_describe ());
+            urj_error_reset ();
+        }
+        urj_bsdl_cache_free (cache);
+    }
+
     return result;
 }
 
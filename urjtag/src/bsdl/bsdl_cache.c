@@ -0,0 +1,434 @@
+/*
+ * $Id$
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307, USA.
+ *
+ * Cache of processed BSDL files
+ *
+ * urj_bsdl_scan_files() parses every file in the BSDL path until one
+ * matches the IDCODE of the part. The cache remembers the IDCODE pattern
+ * of each file and, once a file was applied to a part, the jtag commands
+ * it translates to. Entries are keyed by path and invalidated by
+ * modification time and size of the file.
+ *
+ * File format, one record per line:
+ *   F <mtime> <size> <idcode> <path>
+ *   N <entity>
+ *   C <command>
+ * <idcode> is the pattern from the BSDL file, '-' if it has none and
+ * '!' if the file could not be parsed. N and C lines belong to the
+ * preceding F line; an entry without C lines has not been applied yet.
+ *
+ */
+
+#include <sysdep.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <urjtag/chain.h>
+#include <urjtag/part.h>
+#include <urjtag/parse.h>
+
+#include "bsdl_types.h"
+#include "bsdl_parser.h"
+
+#include "bsdl_msg.h"
+
+#ifdef DMALLOC
+#include "dmalloc.h"
+#endif
+
+#define CACHE_HEADER    "# UrJTAG BSDL cache 1"
+
+
+static void
+cache_entry_clear (urj_bsdl_cache_entry_t *e)
+{
+    free (e->idcode);
+    e->idcode = NULL;
+    free (e->entity);
+    e->entity = NULL;
+    free (e->cmds);
+    e->cmds = NULL;
+    e->cmds_len = 0;
+    e->cmds_size = 0;
+    e->broken = 0;
+}
+
+static void
+cache_entry_free (urj_bsdl_cache_entry_t *e)
+{
+    cache_entry_clear (e);
+    free (e->path);
+    free (e);
+}
+
+static urj_bsdl_cache_entry_t *
+cache_entry_new (urj_bsdl_cache_t *cache, const char *path, long long mtime,
+                 long long size)
+{
+    urj_bsdl_cache_entry_t *e;
+
+    if ((e = calloc (1, sizeof (urj_bsdl_cache_entry_t))) == NULL)
+        return NULL;
+    if ((e->path = strdup (path)) == NULL)
+    {
+        free (e);
+        return NULL;
+    }
+    e->mtime = mtime;
+    e->size = size;
+
+    e->next = cache->entries;
+    cache->entries = e;
+
+    return e;
+}
+
+
+/*****************************************************************************
+ * urj_bsdl_cache_load( file )
+ *
+ * Reads the cache from file. A missing or unreadable file yields an empty
+ * cache.
+ *
+ * Returns
+ *   pointer to cache, NULL if out of memory
+ ****************************************************************************/
+urj_bsdl_cache_t *
+urj_bsdl_cache_load (const char *file)
+{
+    urj_bsdl_cache_t *cache;
+    urj_bsdl_cache_entry_t *e = NULL;
+    FILE *f;
+    char *line = NULL;
+    size_t line_size = 0;
+    ssize_t len;
+
+    if ((cache = calloc (1, sizeof (urj_bsdl_cache_t))) == NULL)
+        return NULL;
+
+    if ((f = fopen (file, FOPEN_R)) == NULL)
+        return cache;
+
+    if ((len = getline (&line, &line_size, f)) <= 0
+        || strncmp (line, CACHE_HEADER, strlen (CACHE_HEADER)) != 0)
+    {
+        /* unknown format, start over */
+        free (line);
+        fclose (f);
+        cache->dirty = 1;
+        return cache;
+    }
+
+    while ((len = getline (&line, &line_size, f)) > 0)
+    {
+        long long mtime, size;
+        char idcode[256];
+        int pos;
+
+        while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r'))
+            line[--len] = '\0';
+
+        if (line[0] == 'F'
+            && sscanf (line, "F %lld %lld %255s %n", &mtime, &size, idcode,
+                       &pos) == 3)
+        {
+            if ((e = cache_entry_new (cache, line + pos, mtime, size)) == NULL)
+                break;
+            if (strcmp (idcode, "!") == 0)
+                e->broken = 1;
+            else if (strcmp (idcode, "-") != 0)
+                e->idcode = strdup (idcode);
+        }
+        else if (line[0] == 'N' && line[1] == ' ' && e != NULL)
+        {
+            free (e->entity);
+            e->entity = strdup (line + 2);
+        }
+        else if (line[0] == 'C' && line[1] == ' ' && e != NULL)
+            urj_bsdl_cache_add_cmd (e, line + 2);
+    }
+
+    free (line);
+    fclose (f);
+
+    return cache;
+}
+
+
+/*****************************************************************************
+ * urj_bsdl_cache_save( cache, file )
+ *
+ * Writes the cache to file if it was modified. Entries of files that
+ * don't exist anymore are dropped.
+ *
+ * Returns
+ *   URJ_STATUS_OK, URJ_STATUS_FAIL
+ ****************************************************************************/
+int
+urj_bsdl_cache_save (urj_bsdl_cache_t *cache, const char *file)
+{
+    urj_bsdl_cache_entry_t *e;
+    char *tmp;
+    FILE *f;
+    int result = URJ_STATUS_OK;
+
+    if (!cache->dirty)
+        return URJ_STATUS_OK;
+
+    if ((tmp = malloc (strlen (file) + 5)) == NULL)
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "malloc(%zd) fails",
+                       strlen (file) + 5);
+        return URJ_STATUS_FAIL;
+    }
+    strcpy (tmp, file);
+    strcat (tmp, ".tmp");
+
+    if ((f = fopen (tmp, FOPEN_W)) == NULL)
+    {
+        urj_error_IO_set (_("Cannot write BSDL cache '%s'"), tmp);
+        free (tmp);
+        return URJ_STATUS_FAIL;
+    }
+
+    fprintf (f, "%s\n", CACHE_HEADER);
+    for (e = cache->entries; e; e = e->next)
+    {
+        struct stat buf;
+        char *cmd;
+
+        if (stat (e->path, &buf) != 0)
+            continue;
+
+        fprintf (f, "F %lld %lld %s %s\n", e->mtime, e->size,
+                 e->broken ? "!" : e->idcode ? e->idcode : "-", e->path);
+        if (e->entity)
+            fprintf (f, "N %s\n", e->entity);
+        for (cmd = e->cmds; cmd && cmd < e->cmds + e->cmds_len;
+             cmd += strlen (cmd) + 1)
+            fprintf (f, "C %s\n", cmd);
+    }
+
+    if (fclose (f) != 0)
+    {
+        urj_error_IO_set (_("Cannot write BSDL cache '%s'"), tmp);
+        result = URJ_STATUS_FAIL;
+    }
+    else
+    {
+#ifdef _WIN32
+        remove (file);
+#endif
+        if (rename (tmp, file) != 0)
+        {
+            urj_error_IO_set (_("Cannot write BSDL cache '%s'"), file);
+            result = URJ_STATUS_FAIL;
+        }
+    }
+
+    if (result != URJ_STATUS_OK)
+        remove (tmp);
+    else
+        cache->dirty = 0;
+    free (tmp);
+
+    return result;
+}
+
+
+void
+urj_bsdl_cache_free (urj_bsdl_cache_t *cache)
+{
+    while (cache->entries)
+    {
+        urj_bsdl_cache_entry_t *e = cache->entries;
+
+        cache->entries = e->next;
+        cache_entry_free (e);
+    }
+    free (cache);
+}
+
+
+/*****************************************************************************
+ * urj_bsdl_cache_lookup( cache, path, mtime, size )
+ *
+ * Returns
+ *   entry of path if it is still valid for the given file state
+ *   NULL otherwise
+ ****************************************************************************/
+urj_bsdl_cache_entry_t *
+urj_bsdl_cache_lookup (urj_bsdl_cache_t *cache, const char *path,
+                       long long mtime, long long size)
+{
+    urj_bsdl_cache_entry_t *e;
+
+    for (e = cache->entries; e; e = e->next)
+        if (strcmp (e->path, path) == 0)
+            return e->mtime == mtime && e->size == size ? e : NULL;
+
+    return NULL;
+}
+
+
+/*****************************************************************************
+ * urj_bsdl_cache_update( cache, path, mtime, size )
+ *
+ * Returns the emptied entry for path, to be filled in by the parser.
+ *
+ * Returns
+ *   pointer to entry, NULL if out of memory
+ ****************************************************************************/
+urj_bsdl_cache_entry_t *
+urj_bsdl_cache_update (urj_bsdl_cache_t *cache, const char *path,
+                       long long mtime, long long size)
+{
+    urj_bsdl_cache_entry_t *e;
+
+    cache->dirty = 1;
+
+    for (e = cache->entries; e; e = e->next)
+        if (strcmp (e->path, path) == 0)
+        {
+            cache_entry_clear (e);
+            e->mtime = mtime;
+            e->size = size;
+            return e;
+        }
+
+    return cache_entry_new (cache, path, mtime, size);
+}
+
+
+/*****************************************************************************
+ * urj_bsdl_cache_add_cmd( entry, cmd )
+ *
+ * Appends a command to the entry. Commands are stored back to back,
+ * each terminated by '\0'.
+ *
+ * Returns
+ *   URJ_STATUS_OK, URJ_STATUS_FAIL
+ ****************************************************************************/
+int
+urj_bsdl_cache_add_cmd (urj_bsdl_cache_entry_t *e, const char *cmd)
+{
+    size_t len = strlen (cmd) + 1;
+
+    if (e->cmds_len + len > e->cmds_size)
+    {
+        size_t size = e->cmds_size ? e->cmds_size : 1024;
+        char *cmds;
+
+        while (e->cmds_len + len > size)
+            size *= 2;
+        if ((cmds = realloc (e->cmds, size)) == NULL)
+        {
+            urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "realloc(%s,%zd) fails",
+                           "e->cmds", size);
+            return URJ_STATUS_FAIL;
+        }
+        e->cmds = cmds;
+        e->cmds_size = size;
+    }
+
+    memcpy (e->cmds + e->cmds_len, cmd, len);
+    e->cmds_len += len;
+
+    return URJ_STATUS_OK;
+}
+
+
+/*****************************************************************************
+ * urj_bsdl_cache_match( entry, idcode )
+ *
+ * Compares idcode against the IDCODE pattern of the entry like the BSDL
+ * stage does, 'X' in the pattern matches any bit.
+ *
+ * Returns
+ *   1 -> idcodes match
+ *   0 -> idcodes don't match
+ ****************************************************************************/
+int
+urj_bsdl_cache_match (const urj_bsdl_cache_entry_t *e, const char *idcode)
+{
+    size_t idx;
+
+    if (e->broken || e->idcode == NULL
+        || strlen (e->idcode) != strlen (idcode))
+        return 0;
+
+    for (idx = 0; idcode[idx]; idx++)
+        if (e->idcode[idx] != 'X' && e->idcode[idx] != idcode[idx])
+            return 0;
+
+    return 1;
+}
+
+
+/*****************************************************************************
+ * urj_bsdl_cache_apply( chain, entry, proc_mode )
+ *
+ * Executes and/or prints the cached commands of the entry as requested
+ * by proc_mode, instead of parsing the BSDL file again.
+ *
+ * Returns
+ *   < 0 : Error occured
+ *   > 0 : No errors, commands applied
+ ****************************************************************************/
+int
+urj_bsdl_cache_apply (urj_chain_t *chain, const urj_bsdl_cache_entry_t *e,
+                      int proc_mode)
+{
+    const char *cmd;
+
+    if ((proc_mode & URJ_BSDL_MODE_INSTR_EXEC) && e->entity)
+    {
+        urj_part_t *part = chain->parts->parts[chain->active_part];
+
+        strncpy (part->part, e->entity, URJ_PART_PART_MAXLEN);
+        part->part[URJ_PART_PART_MAXLEN] = '\0';
+    }
+
+    for (cmd = e->cmds; cmd < e->cmds + e->cmds_len; cmd += strlen (cmd) + 1)
+    {
+        if (proc_mode & URJ_BSDL_MODE_INSTR_EXEC)
+            if (urj_parse_line (chain, cmd) != URJ_STATUS_OK)
+            {
+                urj_bsdl_err (proc_mode,
+                              _("Cached command '%s' for '%s' failed\n"),
+                              cmd, e->path);
+                return -1;
+            }
+        if (proc_mode & URJ_BSDL_MODE_INSTR_PRINT)
+            urj_log (URJ_LOG_LEVEL_NORMAL, "%s\n", cmd);
+    }
+
+    return 1;
+}
+
+
+/*
+ Local Variables:
+ mode:C
+ c-default-style:java
+ indent-tabs-mode:nil
+ End:
+*/
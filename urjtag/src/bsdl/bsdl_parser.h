@@ -46,4 +46,19 @@ int urj_bsdl_parse (urj_bsdl_parser_priv_t *);
 /* BSDL semantic functions */
 int urj_bsdl_process_elements (urj_bsdl_jtag_ctrl_t *, const char *);
 
+/* BSDL cache functions */
+urj_bsdl_cache_t *urj_bsdl_cache_load (const char *);
+int urj_bsdl_cache_save (urj_bsdl_cache_t *, const char *);
+void urj_bsdl_cache_free (urj_bsdl_cache_t *);
+urj_bsdl_cache_entry_t *urj_bsdl_cache_lookup (urj_bsdl_cache_t *,
+                                               const char *, long long,
+                                               long long);
+urj_bsdl_cache_entry_t *urj_bsdl_cache_update (urj_bsdl_cache_t *,
+                                               const char *, long long,
+                                               long long);
+int urj_bsdl_cache_add_cmd (urj_bsdl_cache_entry_t *, const char *);
+int urj_bsdl_cache_match (const urj_bsdl_cache_entry_t *, const char *);
+int urj_bsdl_cache_apply (urj_chain_t *, const urj_bsdl_cache_entry_t *,
+                          int);
+
 #endif /* URJ_BSDL_PARSER_H */
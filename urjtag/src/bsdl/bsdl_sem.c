@@ -27,6 +27,7 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdarg.h>
 #include <string.h>
 
 #include <urjtag/cmd.h>
@@ -49,6 +50,49 @@
 #endif
 
 
+/*****************************************************************************
+ * void urj_bsdl_emit_cmd( urj_bsdl_jtag_ctrl_t *jc, const char *format, ... )
+ *
+ * Prints a generated shell command in INSTR_PRINT mode and records it in
+ * the cache entry of jc if there is one.
+ *
+ * Parameters
+ *   jc     : jtag control structure
+ *   format : printf format of the command, without newline
+ ****************************************************************************/
+static void
+urj_bsdl_emit_cmd (urj_bsdl_jtag_ctrl_t *jc, const char *format, ...)
+{
+    va_list ap;
+    char *cmd;
+    int len;
+
+    if (!(jc->proc_mode & URJ_BSDL_MODE_INSTR_PRINT) && jc->cache == NULL)
+        return;
+
+    va_start (ap, format);
+    len = vsnprintf (NULL, 0, format, ap);
+    va_end (ap);
+
+    if (len < 0 || (cmd = malloc (len + 1)) == NULL)
+    {
+        urj_bsdl_err_set (jc->proc_mode, URJ_ERROR_OUT_OF_MEMORY, "No memory");
+        return;
+    }
+
+    va_start (ap, format);
+    vsnprintf (cmd, len + 1, format, ap);
+    va_end (ap);
+
+    if (jc->proc_mode & URJ_BSDL_MODE_INSTR_PRINT)
+        urj_log (URJ_LOG_LEVEL_NORMAL, "%s\n", cmd);
+    if (jc->cache)
+        urj_bsdl_cache_add_cmd (jc->cache, cmd);
+
+    free (cmd);
+}
+
+
 /*****************************************************************************
  * int urj_bsdl_set_instruction_length( urj_bsdl_jtag_ctrl_t *jc )
  *
@@ -66,8 +110,7 @@ urj_bsdl_set_instruction_length (urj_bsdl_jtag_ctrl_t *jc)
 {
     if (jc->proc_mode & URJ_BSDL_MODE_INSTR_EXEC)
         (void) urj_part_instruction_length_set (jc->part, jc->instr_len);
-    if (jc->proc_mode & URJ_BSDL_MODE_INSTR_PRINT)
-        urj_log (URJ_LOG_LEVEL_NORMAL, "instruction length %i\n", jc->instr_len);
+    urj_bsdl_emit_cmd (jc, "instruction length %i", jc->instr_len);
 
     return URJ_STATUS_OK;
 }
@@ -126,8 +169,7 @@ urj_bsdl_emit_ports (urj_bsdl_jtag_ctrl_t *jc)
 
                     if (jc->proc_mode & URJ_BSDL_MODE_INSTR_EXEC)
                         (void) urj_part_signal_define (jc->chain, port_string);
-                    if (jc->proc_mode & URJ_BSDL_MODE_INSTR_PRINT)
-                        urj_log (URJ_LOG_LEVEL_NORMAL, "signal %s\n", port_string);
+                    urj_bsdl_emit_cmd (jc, "signal %s", port_string);
                 }
 
                 free (port_string);
@@ -174,8 +216,7 @@ create_register (urj_bsdl_jtag_ctrl_t *jc, char *reg_name, size_t len)
 
     if (jc->proc_mode & URJ_BSDL_MODE_INSTR_EXEC)
         result = urj_part_data_register_define (jc->part, reg_name, len);
-    if (jc->proc_mode & URJ_BSDL_MODE_INSTR_PRINT)
-        urj_log (URJ_LOG_LEVEL_NORMAL, "register %s %zd\n", reg_name, len);
+    urj_bsdl_emit_cmd (jc, "register %s %zd", reg_name, len);
 
     return result;
 }
@@ -351,12 +392,10 @@ urj_bsdl_process_cell_info (urj_bsdl_jtag_ctrl_t *jc)
                                                   URJ_BSBIT_STATE_Z) !=
                     URJ_STATUS_OK)
                     return URJ_STATUS_FAIL;
-            if (jc->proc_mode & URJ_BSDL_MODE_INSTR_PRINT)
-                urj_log (URJ_LOG_LEVEL_NORMAL,
-                         "bit %d %c %c %s %d %d %c\n", ci->bit_num,
-                         bsbit_type_char (type), bsbit_safe_char(safe), ci->port_name,
-                         ci->ctrl_bit_num, ci->disable_safe_value,
-                         'Z');
+            urj_bsdl_emit_cmd (jc, "bit %d %c %c %s %d %d %c", ci->bit_num,
+                               bsbit_type_char (type), bsbit_safe_char(safe),
+                               ci->port_name, ci->ctrl_bit_num,
+                               ci->disable_safe_value, 'Z');
         }
         else
         {
@@ -365,10 +404,9 @@ urj_bsdl_process_cell_info (urj_bsdl_jtag_ctrl_t *jc)
                                           ci->port_name, type, safe) !=
                     URJ_STATUS_OK)
                     return URJ_STATUS_FAIL;
-            if (jc->proc_mode & URJ_BSDL_MODE_INSTR_PRINT)
-                urj_log (URJ_LOG_LEVEL_NORMAL,
-                         "bit %d %c %c %s\n", ci->bit_num,
-                         bsbit_type_char (type), bsbit_safe_char(safe), ci->port_name);
+            urj_bsdl_emit_cmd (jc, "bit %d %c %c %s", ci->bit_num,
+                               bsbit_type_char (type), bsbit_safe_char(safe),
+                               ci->port_name);
         }
 
         ci = ci->next;
@@ -518,10 +556,8 @@ urj_bsdl_process_register_access (urj_bsdl_jtag_ctrl_t *jc)
                                                  cinst->opcode, reg_name) ==
                     NULL)
                     return URJ_STATUS_FAIL;
-            if (jc->proc_mode & URJ_BSDL_MODE_INSTR_PRINT)
-                urj_log (URJ_LOG_LEVEL_NORMAL,
-                         "instruction %s %s %s\n", instr_name, cinst->opcode,
-                         reg_name);
+            urj_bsdl_emit_cmd (jc, "instruction %s %s %s", instr_name,
+                               cinst->opcode, reg_name);
         }
 
         cinst = cinst->next;
@@ -710,6 +746,8 @@ urj_bsdl_process_elements (urj_bsdl_jtag_ctrl_t *jc, const char *idcode)
         {
             urj_bsdl_err (jc->proc_mode,
                           _("BSDL stage reported errors, aborting.\n"));
+            if (jc->cache)
+                jc->cache->broken = 1;
             urj_bsdl_parser_deinit (priv);
             return -1;
         }
@@ -718,6 +756,10 @@ urj_bsdl_process_elements (urj_bsdl_jtag_ctrl_t *jc, const char *idcode)
     if (jc->idcode)
         urj_bsdl_msg (jc->proc_mode, _("Got IDCODE: %s\n"), jc->idcode);
 
+    /* the cache remembers the IDCODE even if it doesn't match */
+    if (jc->cache && jc->idcode)
+        jc->cache->idcode = strdup (jc->idcode);
+
     if (jc->proc_mode & URJ_BSDL_MODE_IDCODE_CHECK)
         result |= compare_idcode (jc, idcode);
 
@@ -131,6 +131,31 @@ typedef enum
     URJ_BSDL_CONF_UNKNOWN
 } urj_bsdl_conformance_t;
 
+/* entry of the BSDL cache
+   holds the IDCODE pattern of a BSDL file and, once the file was applied
+   to a part, the jtag commands it translates to */
+struct cache_entry
+{
+    struct cache_entry *next;
+    char *path;
+    long long mtime;
+    long long size;
+    int broken;                 /* file failed to parse */
+    char *idcode;               /* IDCODE pattern, NULL if none */
+    char *entity;               /* entity name, becomes the part name */
+    char *cmds;                 /* commands, one per line, NULL if unknown */
+    size_t cmds_len;
+    size_t cmds_size;
+};
+typedef struct cache_entry urj_bsdl_cache_entry_t;
+
+struct cache
+{
+    urj_bsdl_cache_entry_t *entries;
+    int dirty;
+};
+typedef struct cache urj_bsdl_cache_t;
+
 /* structure jtag_ctrl collects all elements that are required to interface
    with jtag internals */
 struct jtag_ctrl
@@ -152,6 +177,8 @@ struct jtag_ctrl
     urj_bsdl_types_ainfo_elem_t *ainfo_list;
     urj_bsdl_cell_info_t *cell_info_first;
     urj_bsdl_cell_info_t *cell_info_last;
+    /* collects IDCODE and commands for the BSDL cache if not NULL */
+    urj_bsdl_cache_entry_t *cache;
 };
 typedef struct jtag_ctrl urj_bsdl_jtag_ctrl_t;
 
@@ -922,8 +922,10 @@ urj_vhdl_set_entity (urj_vhdl_parser_priv_t *priv, char *entityname)
                  URJ_PART_PART_MAXLEN);
         priv->jtag_ctrl->part->part[URJ_PART_PART_MAXLEN] = '\0';
     }
-
-    free (entityname);
+    if (priv->jtag_ctrl->cache && priv->jtag_ctrl->cache->entity == NULL)
+        priv->jtag_ctrl->cache->entity = entityname;
+    else
+        free (entityname);
 }
 
 /*****************************************************************************
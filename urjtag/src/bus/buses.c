@@ -180,6 +180,45 @@ urj_bus_init (urj_chain_t *chain, const char *drivername, char *params[])
     return ret;
 }
 
+int
+urj_bus_read_block (urj_bus_t *bus, uint32_t addr, uint32_t step,
+                    uint32_t *data, uint32_t count)
+{
+    uint32_t i;
+
+    if (count == 0)
+        return URJ_STATUS_OK;
+
+    if (bus->driver->read_block)
+        return bus->driver->read_block (bus, addr, step, data, count);
+
+    if (URJ_BUS_READ_START (bus, addr) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+    for (i = 1; i < count; i++)
+        data[i - 1] = URJ_BUS_READ_NEXT (bus, addr + i * step);
+    data[count - 1] = URJ_BUS_READ_END (bus);
+
+    return URJ_STATUS_OK;
+}
+
+int
+urj_bus_write_block (urj_bus_t *bus, uint32_t addr, uint32_t step,
+                     const uint32_t *data, uint32_t count)
+{
+    uint32_t i;
+
+    if (count == 0)
+        return URJ_STATUS_OK;
+
+    if (bus->driver->write_block)
+        return bus->driver->write_block (bus, addr, step, data, count);
+
+    for (i = 0; i < count; i++)
+        URJ_BUS_WRITE (bus, addr + i * step, data[i]);
+
+    return URJ_STATUS_OK;
+}
+
 urj_bus_t *
 urj_bus_init_bus (urj_chain_t *chain, const urj_bus_driver_t *bus_driver,
                   const urj_param_t *param[])
@@ -159,3 +159,88 @@ urj_bus_generic_read (urj_bus_t *bus, uint32_t adr)
     URJ_BUS_READ_START (bus, adr);
     return URJ_BUS_READ_END (bus);
 }
+
+/* words per burst, bounds the memory for the recorded registers */
+#define BURST_WORDS     256
+
+static void
+generic_read_words (urj_bus_t *bus, uint32_t adr, uint32_t step,
+                    uint32_t *data, uint32_t count)
+{
+    uint32_t i;
+
+    // @@@@ RFHH check status
+    URJ_BUS_READ_START (bus, adr);
+    for (i = 1; i < count; i++)
+        data[i - 1] = URJ_BUS_READ_NEXT (bus, adr + i * step);
+    data[count - 1] = URJ_BUS_READ_END (bus);
+}
+
+/**
+ * bus->driver->(*read_block)
+ *
+ * The driver's read_start/read_next/read_end run twice per burst: first with
+ * the EXTEST shifts only queued on the cable, then, after one flush, once
+ * more with the recorded outputs loaded into the BSR.  Only usable by
+ * drivers whose shifts depend on nothing but the addresses, i.e. that do not
+ * poll signals or change instructions while reading.
+ */
+int
+urj_bus_generic_read_block (urj_bus_t *bus, uint32_t adr, uint32_t step,
+                            uint32_t *data, uint32_t count)
+{
+    while (count > 0)
+    {
+        uint32_t n = count < BURST_WORDS ? count : BURST_WORDS;
+
+        if (urj_tap_chain_burst_start (bus->chain) != URJ_STATUS_OK)
+            return URJ_STATUS_FAIL;
+
+        generic_read_words (bus, adr, step, data, n);
+        if (urj_tap_chain_burst_replay (bus->chain) != URJ_STATUS_OK)
+        {
+            urj_tap_chain_burst_end (bus->chain);
+            return URJ_STATUS_FAIL;
+        }
+        generic_read_words (bus, adr, step, data, n);
+        if (urj_tap_chain_burst_end (bus->chain) != URJ_STATUS_OK)
+            return URJ_STATUS_FAIL;
+
+        adr += n * step;
+        data += n;
+        count -= n;
+    }
+
+    return URJ_STATUS_OK;
+}
+
+/**
+ * bus->driver->(*write_block)
+ *
+ * Queues the EXTEST shifts of all writes of a burst and flushes once; the
+ * same restrictions as for urj_bus_generic_read_block() apply.
+ */
+int
+urj_bus_generic_write_block (urj_bus_t *bus, uint32_t adr, uint32_t step,
+                             const uint32_t *data, uint32_t count)
+{
+    while (count > 0)
+    {
+        uint32_t n = count < BURST_WORDS ? count : BURST_WORDS;
+        uint32_t i;
+
+        if (urj_tap_chain_burst_start (bus->chain) != URJ_STATUS_OK)
+            return URJ_STATUS_FAIL;
+
+        for (i = 0; i < n; i++)
+            URJ_BUS_WRITE (bus, adr + i * step, data[i]);
+        if (urj_tap_chain_burst_end (bus->chain) != URJ_STATUS_OK)
+            return URJ_STATUS_FAIL;
+
+        adr += n * step;
+        data += n;
+        count -= n;
+    }
+
+    return URJ_STATUS_OK;
+}
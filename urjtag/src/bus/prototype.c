@@ -532,4 +532,6 @@ const urj_bus_driver_t urj_bus_prototype_bus = {
     urj_bus_generic_no_enable,
     urj_bus_generic_no_disable,
     URJ_BUS_TYPE_PARALLEL,
+    urj_bus_generic_read_block,
+    urj_bus_generic_write_block,
 };
@@ -47,6 +47,7 @@ urj_bus_readmem (urj_bus_t *bus, FILE *f, uint32_t addr, uint32_t len)
     size_t bc = 0;
 #define BSIZE 4096
     uint8_t b[BSIZE];
+    uint32_t w[BSIZE];
     urj_bus_area_t area;
     uint64_t end;
 
@@ -93,40 +94,39 @@ urj_bus_readmem (urj_bus_t *bus, FILE *f, uint32_t addr, uint32_t len)
     end = a + len;
     urj_log (URJ_LOG_LEVEL_NORMAL, _("reading:\n"));
 
-    if (URJ_BUS_READ_START (bus, addr) != URJ_STATUS_OK)
-        return URJ_STATUS_FAIL;
-
-    for (a += step; a <= end; a += step)
+    while (a < end)
     {
-        uint32_t data;
-        int j;
-
-        if (a < end)
-            data = URJ_BUS_READ_NEXT (bus, a);
-        else
-            data = URJ_BUS_READ_END (bus);
-
-        for (j = step; j > 0; j--)
-            if (urj_get_file_endian () == URJ_ENDIAN_BIG)
-                b[bc++] = (data >> ((j - 1) * 8)) & 0xFF;
-            else
-            {
-                b[bc++] = data & 0xFF;
-                data >>= 8;
-            }
-
-        if ((bc >= BSIZE) || (a >= end))
+        uint32_t n = (end - a < BSIZE ? end - a : BSIZE) / step;
+        uint32_t i;
+
+        /* one block of words, the bus driver may transfer it in a burst */
+        if (urj_bus_read_block (bus, a, step, w, n) != URJ_STATUS_OK)
+            return URJ_STATUS_FAIL;
+
+        for (i = 0, bc = 0; i < n; i++)
+        {
+            uint32_t data = w[i];
+            int j;
+
+            for (j = step; j > 0; j--)
+                if (urj_get_file_endian () == URJ_ENDIAN_BIG)
+                    b[bc++] = (data >> ((j - 1) * 8)) & 0xFF;
+                else
+                {
+                    b[bc++] = data & 0xFF;
+                    data >>= 8;
+                }
+        }
+        a += bc;
+
+        urj_log (URJ_LOG_LEVEL_NORMAL, _("addr: 0x%08llX\r"),
+                 (long long unsigned) a);
+        if (fwrite (b, bc, 1, f) != 1)
         {
-            urj_log (URJ_LOG_LEVEL_NORMAL, _("addr: 0x%08llX\r"),
-                     (long long unsigned) a);
-            if (fwrite (b, bc, 1, f) != 1)
-            {
-                urj_error_set (URJ_ERROR_FILEIO, "fwrite fails");
-                urj_error_state.sys_errno = ferror(f);
-                clearerr(f);
-                return URJ_STATUS_FAIL;
-            }
-            bc = 0;
+            urj_error_set (URJ_ERROR_FILEIO, "fwrite fails");
+            urj_error_state.sys_errno = ferror(f);
+            clearerr(f);
+            return URJ_STATUS_FAIL;
         }
     }
 
@@ -41,6 +41,8 @@ urj_bus_writemem (urj_bus_t *bus, FILE *f, uint32_t addr, uint32_t len)
     int bidx = 0;
 #define BSIZE 4096
     uint8_t b[BSIZE];
+    uint32_t w[BSIZE];
+    uint32_t wc = 0;
     urj_bus_area_t area;
     uint64_t end;
 
@@ -95,6 +97,12 @@ urj_bus_writemem (urj_bus_t *bus, FILE *f, uint32_t addr, uint32_t len)
         /* Read one block of data */
         if (bc == 0)
         {
+            /* write the words of the previous block, possibly in a burst */
+            if (urj_bus_write_block (bus, a - wc * step, step, w, wc)
+                != URJ_STATUS_OK)
+                return URJ_STATUS_FAIL;
+            wc = 0;
+
             urj_log (URJ_LOG_LEVEL_NORMAL, _("addr: 0x%08llX\r"),
                      (long long unsigned) a);
             bc = fread (b, 1, BSIZE, f);
@@ -124,7 +132,7 @@ urj_bus_writemem (urj_bus_t *bus, FILE *f, uint32_t addr, uint32_t len)
             bidx = 0;
         }
 
-        /* Write a word at a time */
+        /* Collect a word at a time */
         data = 0;
         for (j = step; j > 0 && bc > 0; j--)
         {
@@ -139,9 +147,12 @@ urj_bus_writemem (urj_bus_t *bus, FILE *f, uint32_t addr, uint32_t len)
             bc--;
         }
 
-        URJ_BUS_WRITE (bus, a, data);
+        w[wc++] = data;
     }
 
+    if (urj_bus_write_block (bus, a - wc * step, step, w, wc) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
     urj_log (URJ_LOG_LEVEL_NORMAL, _("\nDone.\n"));
 
     return URJ_STATUS_OK;
@@ -91,6 +91,15 @@ cmd_bsdl_run (urj_chain_t *chain, char *params[])
             result = 1;
         }
 
+        if (strcmp (params[1], "cache") == 0)
+        {
+            if (urj_bsdl_set_cache (chain, strcmp (params[2], "off") == 0
+                                           ? NULL : params[2])
+                != URJ_STATUS_OK)
+                return URJ_STATUS_FAIL;
+            result = 1;
+        }
+
         if (strcmp (params[1], "debug") == 0)
         {
             if (strcmp (params[2], "on") == 0)
@@ -126,6 +135,7 @@ cmd_bsdl_complete (urj_chain_t *chain, char ***matches, size_t *match_cnt,
         "test",
         "dump",
         "debug",
+        "cache",
     };
 
     static const char * const debug_cmds[] = {
@@ -141,7 +151,7 @@ cmd_bsdl_complete (urj_chain_t *chain, char ***matches, size_t *match_cnt,
 
     case 2:
         /* XXX: For "test" and "dump", we'll want to search the bsdl paths */
-        if (!strcmp (tokens[1], "path"))
+        if (!strcmp (tokens[1], "path") || !strcmp (tokens[1], "cache"))
             urj_completion_mayben_add_file (matches, match_cnt, text,
                                             text_len, false);
         else if (!strcmp (tokens[1], "debug"))
@@ -159,11 +169,14 @@ cmd_bsdl_help (void)
                "Usage: %s test [FILE]\n"
                "Usage: %s dump [FILE]\n"
                "Usage: %s debug on|off\n"
+               "Usage: %s cache CACHEFILE|off\n"
                "Manage BSDL files\n"
                "\n"
                "PATHLIST semicolon separated list of directory paths to search for BSDL files\n"
-               "FILE file containing part description in BSDL format\n"),
-            "bsdl", "bsdl", "bsdl", "bsdl");
+               "FILE file containing part description in BSDL format\n"
+               "CACHEFILE file remembering IDCODE and contents of the files in PATHLIST,\n"
+               "          so that 'detect' only parses new or modified BSDL files\n"),
+            "bsdl", "bsdl", "bsdl", "bsdl", "bsdl");
 }
 
 const urj_cmd_t urj_cmd_bsdl = {
@@ -42,9 +42,11 @@ cmd_flashmem_run (urj_chain_t *chain, char *params[])
 {
     int msbin;
     int noverify = 0;
+    int diff = 0;
     long unsigned adr = 0;
     FILE *f;
     int paramc = urj_cmd_params (params);
+    int i;
     int r;
 
     if (paramc < 3)
@@ -65,10 +67,19 @@ cmd_flashmem_run (urj_chain_t *chain, char *params[])
     if (!msbin && urj_cmd_get_number (params[1], &adr) != URJ_STATUS_OK)
         return URJ_STATUS_FAIL;
 
-    if (paramc > 3)
-        noverify = strcasecmp ("noverify", params[3]) == 0;
-    else
-        noverify = 0;
+    for (i = 3; i < paramc; i++)
+        if (strcasecmp ("noverify", params[i]) == 0)
+            noverify = 1;
+        else if (strcasecmp ("diff", params[i]) == 0)
+            diff = 1;
+
+    if (msbin && diff)
+    {
+        urj_error_set (URJ_ERROR_UNSUPPORTED,
+                       _("%s: 'diff' is not supported for msbin images"),
+                       params[0]);
+        return URJ_STATUS_FAIL;
+    }
 
     f = fopen (params[2], FOPEN_R);
     if (!f)
@@ -79,6 +90,8 @@ cmd_flashmem_run (urj_chain_t *chain, char *params[])
 
     if (msbin)
         r = urj_flashmsbin (urj_bus, f, noverify);
+    else if (diff)
+        r = urj_flashmem_diff (urj_bus, f, adr, noverify);
     else
         r = urj_flashmem (urj_bus, f, adr, noverify);
 
@@ -91,7 +104,7 @@ static void
 cmd_flashmem_help (void)
 {
     urj_log (URJ_LOG_LEVEL_NORMAL,
-             _("Usage: %s ADDR FILENAME [noverify]\n"
+             _("Usage: %s ADDR FILENAME [noverify] [diff]\n"
                "Usage: %s FILENAME [noverify]\n"
                "Program FILENAME content to flash memory.\n"
                "\n"
@@ -99,11 +112,13 @@ cmd_flashmem_help (void)
                "FILENAME   name of the input file\n"
                "%-10s FILENAME is in MS .bin format (for WinCE)\n"
                "%-10s if specified, verification is skipped\n"
+               "%-10s if specified, blocks already holding the image data are\n"
+               "           neither erased nor programmed\n"
                "\n"
                "ADDR could be in decimal or hexadecimal (prefixed with 0x) form.\n"
                "\n"
                "Supported Flash Memories:\n"),
-             "flashmem", "flashmem msbin", "msbin", "noverify");
+             "flashmem", "flashmem msbin", "msbin", "noverify", "diff");
 
     urj_cmd_show_list (urj_flash_flash_drivers);
 }
@@ -123,8 +138,10 @@ cmd_flashmem_complete (urj_chain_t *chain, char ***matches, size_t *match_cnt,
                                         text_len, false);
         break;
 
-    case 3: /* [noverify] */
+    case 3: /* [noverify] [diff] */
+    case 4:
         urj_completion_mayben_add_match (matches, match_cnt, text, text_len, "noverify");
+        urj_completion_mayben_add_match (matches, match_cnt, text, text_len, "diff");
         break;
     }
 }
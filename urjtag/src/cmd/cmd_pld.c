@@ -124,6 +124,65 @@ cmd_pld_run (urj_chain_t *chain, char *params[])
     {
         result = urj_pld_reconfigure (chain);
     }
+    else if (strcasecmp (params[1], "readback") == 0)
+    {
+        unsigned long len;
+
+        if (num_params < 4)
+        {
+            urj_error_set (URJ_ERROR_SYNTAX,
+                           _("%s: #parameters should be >= %d, not %d"),
+                           params[0], 4, urj_cmd_params (params));
+            return URJ_STATUS_FAIL;
+        }
+
+        if (urj_cmd_get_number (params[3], &len) != URJ_STATUS_OK)
+            return URJ_STATUS_FAIL;
+
+        if (len == 0)
+        {
+            urj_error_set (URJ_ERROR_SYNTAX,
+                           _("%s: LENGTH must not be 0"), params[0]);
+            return URJ_STATUS_FAIL;
+        }
+
+        result = urj_pld_readback (chain, params[2], len);
+    }
+    else if (strcasecmp (params[1], "verify") == 0)
+    {
+        FILE *mask_file = NULL;
+
+        if (num_params < 3)
+        {
+            urj_error_set (URJ_ERROR_SYNTAX,
+                           _("%s: no filename specified"),
+                           params[0]);
+            return URJ_STATUS_FAIL;
+        }
+
+        if (num_params > 3
+            && (mask_file = fopen (params[3], FOPEN_R)) == NULL)
+        {
+            urj_error_IO_set (_("%s: cannot open file '%s'"),
+                              params[0], params[3]);
+            return URJ_STATUS_FAIL;
+        }
+
+        if ((pld_file = fopen (params[2], FOPEN_R)) != NULL)
+        {
+            result = urj_pld_verify (chain, pld_file, mask_file);
+            fclose (pld_file);
+        }
+        else
+        {
+            urj_error_IO_set (_("%s: cannot open file '%s'"),
+                              params[0], params[2]);
+            result = URJ_STATUS_FAIL;
+        }
+
+        if (mask_file != NULL)
+            fclose (mask_file);
+    }
     else
     {
         urj_error_set (URJ_ERROR_SYNTAX,
@@ -144,8 +203,14 @@ cmd_pld_help (void)
                "Usage: %s status\n"
                "Usage: %s readreg REG\n"
                "Usage: %s writereg REG VALUE\n"
-               "Configure FPGA from PLDFILE, query status, read and write registers.\n"),
-             "pld", "pld", "pld", "pld", "pld");
+               "Usage: %s readback FILE LENGTH\n"
+               "Usage: %s verify FILE [MASKFILE]\n"
+               "Configure FPGA from PLDFILE, query status, read and write registers.\n"
+               "\n"
+               "readback writes LENGTH bytes of configuration data to FILE.\n"
+               "verify reads back as many bytes as FILE holds and compares them\n"
+               "with FILE; bits set in the raw binary MASKFILE are ignored.\n"),
+             "pld", "pld", "pld", "pld", "pld", "pld", "pld");
 }
 
 const urj_cmd_t urj_cmd_pld = {
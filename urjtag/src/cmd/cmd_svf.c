@@ -39,6 +39,48 @@
 
 #include "cmd.h"
 
+static int
+cmd_svf_compile (urj_chain_t *chain, char *params[])
+{
+    FILE *SVF_FILE, *out;
+    int result;
+
+    if (urj_cmd_params (params) != 4)
+    {
+        urj_error_set (URJ_ERROR_SYNTAX,
+                       "%s: #parameters should be %d, not %d",
+                       params[0], 4, urj_cmd_params (params));
+        return URJ_STATUS_FAIL;
+    }
+
+    if ((SVF_FILE = fopen (params[2], FOPEN_R)) == NULL)
+    {
+        urj_error_IO_set ("%s: cannot open file '%s'", params[0], params[2]);
+        return URJ_STATUS_FAIL;
+    }
+    if ((out = fopen (params[3], FOPEN_W)) == NULL)
+    {
+        urj_error_IO_set ("%s: cannot open file '%s'", params[0], params[3]);
+        fclose (SVF_FILE);
+        return URJ_STATUS_FAIL;
+    }
+
+    result = urj_svf_compile (chain, SVF_FILE, out);
+
+    if (fclose (out) != 0 && result == URJ_STATUS_OK)
+    {
+        urj_error_IO_set ("%s: cannot write file '%s'", params[0], params[3]);
+        result = URJ_STATUS_FAIL;
+    }
+    fclose (SVF_FILE);
+
+    /* don't leave a truncated stream behind */
+    if (result != URJ_STATUS_OK)
+        remove (params[3]);
+
+    return result;
+}
+
 static int
 cmd_svf_run (urj_chain_t *chain, char *params[])
 {
@@ -46,6 +88,7 @@ cmd_svf_run (urj_chain_t *chain, char *params[])
     int num_params, i;
     int stop = 0;
     int print_progress = 0;
+    int depth = 0;
     uint32_t ref_freq = 0;
     urj_log_level_t old_log_level = urj_log_state.level;
     int result = URJ_STATUS_OK;
@@ -59,6 +102,9 @@ cmd_svf_run (urj_chain_t *chain, char *params[])
         return URJ_STATUS_FAIL;
     }
 
+    if (strcasecmp (params[1], "compile") == 0)
+        return cmd_svf_compile (chain, params);
+
     for (i = 2; i < num_params; i++)
     {
         if (strcasecmp (params[i], "stop") == 0)
@@ -67,6 +113,10 @@ cmd_svf_run (urj_chain_t *chain, char *params[])
             print_progress = 1;
         else if (strncasecmp (params[i], "ref_freq=", 9) == 0)
             ref_freq = strtol (params[i] + 9, NULL, 10);
+        else if (strcasecmp (params[i], "pipeline") == 0)
+            depth = URJ_SVF_PIPELINE_DEPTH;
+        else if (strncasecmp (params[i], "pipeline=", 9) == 0)
+            depth = strtol (params[i] + 9, NULL, 10);
         else
         {
             urj_error_set (URJ_ERROR_SYNTAX, "%s: unknown command '%s'",
@@ -80,7 +130,11 @@ cmd_svf_run (urj_chain_t *chain, char *params[])
 
     if ((SVF_FILE = fopen (params[1], FOPEN_R)) != NULL)
     {
-        result = urj_svf_run (chain, SVF_FILE, stop, ref_freq);
+        if (urj_svf_is_compiled (SVF_FILE))
+            result = urj_svf_play (chain, SVF_FILE, stop, ref_freq);
+        else
+            result = urj_svf_run_pipelined (chain, SVF_FILE, stop, ref_freq,
+                                            depth);
 
         fclose (SVF_FILE);
     }
@@ -104,15 +158,30 @@ cmd_svf_complete (urj_chain_t *chain, char ***matches, size_t *match_cnt,
         "stop",
         "progress",
         "ref_freq=",
+        "pipeline",
     };
 
     switch (token_point)
     {
     case 1:
+        urj_completion_mayben_add_match (matches, match_cnt, text, text_len,
+                                         "compile");
         urj_completion_mayben_add_file (matches, match_cnt, text,
                                         text_len, false);
         break;
 
+    case 2:
+    case 3:
+        if (strcasecmp (tokens[1], "compile") == 0)
+        {
+            urj_completion_mayben_add_file (matches, match_cnt, text,
+                                            text_len, false);
+            break;
+        }
+        urj_completion_mayben_add_matches (matches, match_cnt, text, text_len,
+                                           main_cmds);
+        break;
+
     default:
         urj_completion_mayben_add_matches (matches, match_cnt, text, text_len,
                                            main_cmds);
@@ -124,13 +193,20 @@ static void
 cmd_svf_help (void)
 {
     urj_log (URJ_LOG_LEVEL_NORMAL,
-             _("Usage: %s FILE [stop] [progress] [ref_freq=<frequency>]\n"
+             _("Usage: %s FILE [stop] [progress] [ref_freq=<frequency>] [pipeline[=<depth>]]\n"
+               "Usage: %s compile FILE OUTFILE\n"
                "Execute svf commands from FILE.\n"
+               "FILE may also be a file written by 'compile', which translates the\n"
+               "commands for the current chain into a binary stream that is played\n"
+               "without parsing (TDO checks are pipelined, see below).\n"
                "stop     : Command execution stops upon TDO mismatch.\n"
                "progress : Continually displays progress status.\n"
                "ref_freq : Use <frequency> as the reference for 'RUNTEST xxx SEC' commands\n"
+               "pipeline : Check up to <depth> (default %d) TDO values late instead of\n"
+               "           waiting for each; with stop, commands after a mismatch may\n"
+               "           already have been executed.\n"
                "\n" "FILE file containing SVF commands\n"),
-             "svf");
+             "svf", "svf", URJ_SVF_PIPELINE_DEPTH);
 }
 
 const urj_cmd_t urj_cmd_svf = {
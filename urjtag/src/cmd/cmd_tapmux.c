@@ -36,6 +36,13 @@
 
 #include "cmd.h"
 
+//
+// regcache.c
+//
+
+#include "../hudi/regcache.h"
+#include "../hudi/regcache.c"
+
 //
 // tapmux.c
 //
@@ -113,6 +120,38 @@ stdi_subcommand(urj_chain_t *chain, int n, int m, char *params[])
   return URJ_STATUS_FAIL;
 }
 
+static int
+hudi_subcommand(urj_chain_t *chain, int n, int m, char *params[])
+{
+  for(; n<m; n++) {
+    if (strncasecmp(params[n], "dump", 4) == 0) {
+      long unsigned adr, len;
+      FILE *f;
+      int r;
+      if ((n+3) >= m) {
+	urj_error_set (URJ_ERROR_SYNTAX, "missing address, length and/or filename for dump");
+	return URJ_STATUS_FAIL;
+      }
+      if (urj_cmd_get_number (params[n+1], &adr) != URJ_STATUS_OK
+	  || urj_cmd_get_number (params[n+2], &len) != URJ_STATUS_OK)
+	return URJ_STATUS_FAIL;
+      f = fopen (params[n+3], FOPEN_W);
+      if (!f) {
+	urj_error_IO_set ("Unable to create file `%s'", params[n+3]);
+	return URJ_STATUS_FAIL;
+      }
+      r = hudi_stdi_dump(chain, f, adr, len);
+      fclose (f);
+      return r;
+    }
+    else {
+      urj_error_set (URJ_ERROR_SYNTAX, "illegal hudi subcommand '%s'", params[n]);
+      return URJ_STATUS_FAIL;
+    }
+  }
+  return URJ_STATUS_FAIL;
+}
+
 static int
 dsu_subcommand(urj_chain_t *chain, int n, int m, char *params[])
 {
@@ -192,6 +231,11 @@ cmd_tapmux_run (urj_chain_t *chain, char *params[])
 	urj_error_set (URJ_ERROR_SYNTAX, "missing subcommand for stdi");
       j++;
       return stdi_subcommand(chain,j,i,params);
+    } else if (strncasecmp(params[j], "hudi", 4) == 0) {
+      if ((j+1) == i)
+	urj_error_set (URJ_ERROR_SYNTAX, "missing subcommand for hudi");
+      j++;
+      return hudi_subcommand(chain,j,i,params);
     } else if (strncasecmp(params[j], "dsu", 3) == 0) {
       if ((j+1) == i)
 	urj_error_set (URJ_ERROR_SYNTAX, "missing subcommand for dsu");
@@ -216,6 +260,7 @@ cmd_tapmux_help (void)
              _("Usage: tapmux bypass N\n"
 	       "Usage: tapmux printids\n"
 	       "Usage: tapmux stdi [...]\n"
+	       "Usage: tapmux hudi [...]\n"
 	       "Usage: tapmux dsu [..]\n"
                "bypass   : bypass tmc to core N (N=0-3).\n"
                "printids : print ids of current core (st40 only).\n"
@@ -223,6 +268,9 @@ cmd_tapmux_help (void)
 	       " stdi file FILE OFFSET : load stmc stdi file w/ given overlay OFFSET.\n"
 	       " stdi attach           : attach to st40.\n"
 	       " stdi detach           : detach from st40.\n"
+	       "hudi     : hudi sub commands (st40 only).\n"
+	       " hudi dump ADDR LEN FILE : dump LEN bytes of st40 memory at ADDR to FILE\n"
+	       "                           using the stdi peek longs overlay.\n"
                "dsu      : dsu sub commands (st231 only).\n"
 	       " dsu dpeek             : read and print all dsu registers.\n"
 	       " dsu dpeek REG         : read and print dsu register REG 0-31.\n"
@@ -264,6 +264,8 @@ urj_flashmsbin (urj_bus_t *bus, FILE *f, int noverify)
     return URJ_STATUS_OK;
 }
 
+#define BSIZE (1 << 12)
+
 static int
 find_block (urj_flash_cfi_query_structure_t *cfi, int adr, int bus_width,
             int chip_width, int *bytes_until_next_block)
@@ -294,8 +296,84 @@ find_block (urj_flash_cfi_query_structure_t *cfi, int adr, int bus_width,
     return -1;
 }
 
-int
-urj_flashmem (urj_bus_t *bus, FILE *f, uint32_t addr, int noverify)
+/*
+ * Compare the next len bytes of f with the flash contents at adr; the file
+ * position is restored afterwards.
+ * @return 1 if they differ, 0 if they match, -1 on error
+ */
+static int
+block_differs (urj_bus_t *bus, FILE *f, uint32_t adr, int len,
+               uint32_t *buffer, int buffer_len)
+{
+    int bus_width = flash_driver->bus_width;
+    long pos = ftell (f);
+    uint8_t b[BSIZE];
+    int differs = 0;
+
+    if (pos < 0)
+    {
+        urj_error_IO_set ("ftell fails");
+        return -1;
+    }
+
+    flash_driver->readarray (urj_flash_cfi_array);
+
+    while (len > 0 && !differs)
+    {
+        int bc, bn, btr = len < buffer_len ? len : buffer_len;
+
+        bn = fread (b, 1, btr, f);
+        if (bn <= 0)
+            break;
+        /* a partial last word is never considered unchanged */
+        if (bn % bus_width != 0)
+        {
+            differs = 1;
+            break;
+        }
+
+        if (urj_bus_read_block (bus, adr, bus_width, buffer, bn / bus_width)
+            != URJ_STATUS_OK)
+            return -1;
+
+        for (bc = 0; bc < bn; bc += bus_width)
+        {
+            uint32_t data = 0;
+            int j;
+
+            for (j = 0; j < bus_width; j++)
+                if (urj_get_file_endian () == URJ_ENDIAN_BIG)
+                    data = (data << 8) | b[bc + j];
+                else
+                    data |= b[bc + j] << (j * 8);
+
+            if (data != buffer[bc / bus_width])
+            {
+                differs = 1;
+                break;
+            }
+        }
+
+        adr += bn;
+        len -= bn;
+    }
+
+    if (fseek (f, pos, SEEK_SET) != 0)
+    {
+        urj_error_IO_set ("fseek fails");
+        return -1;
+    }
+
+    return differs;
+}
+
+/* states of the erase blocks during urj_flashmem() */
+#define BLOCK_UNTOUCHED 0
+#define BLOCK_ERASED    1
+#define BLOCK_UNCHANGED 2
+
+static int
+flashmem (urj_bus_t *bus, FILE *f, uint32_t addr, int noverify, int diff)
 {
     uint32_t adr;
     urj_flash_cfi_query_structure_t *cfi;
@@ -304,7 +382,6 @@ urj_flashmem (urj_bus_t *bus, FILE *f, uint32_t addr, int noverify)
     int neb;
     int bus_width;
     int chip_width;
-#define BSIZE (1 << 12)
     uint32_t write_buffer[BSIZE];
     int write_buffer_count;
     uint32_t write_buffer_adr;
@@ -333,7 +410,7 @@ urj_flashmem (urj_bus_t *bus, FILE *f, uint32_t addr, int noverify)
         return URJ_STATUS_FAIL;
     }
     for (i = 0; i < neb; i++)
-        erased[i] = 0;
+        erased[i] = BLOCK_UNTOUCHED;
 
     urj_log (URJ_LOG_LEVEL_NORMAL, _("program:\n"));
     adr = addr;
@@ -348,12 +425,37 @@ urj_flashmem (urj_bus_t *bus, FILE *f, uint32_t addr, int noverify)
         write_buffer_count = 0;
         write_buffer_adr = adr;
 
+        /* the first time a block is touched, check whether its part of the
+           image differs from the flash contents at all */
+        if (diff && erased[block_no] == BLOCK_UNTOUCHED)
+        {
+            int r = block_differs (bus, f, adr, btr, write_buffer, BSIZE);
+
+            if (r < 0)
+            {
+                free (erased);
+                return URJ_STATUS_FAIL;
+            }
+            if (r == 0)
+            {
+                urj_log (URJ_LOG_LEVEL_NORMAL,
+                         _("\nblock %d unchanged, skipped\n"), block_no);
+                erased[block_no] = BLOCK_UNCHANGED;
+            }
+        }
+
         if (btr > BSIZE)
             btr = BSIZE;
         // @@@@ RFHH check error state?
         bn = fread (b, 1, btr, f);
 
-        if (bn > 0 && !erased[block_no])
+        if (erased[block_no] == BLOCK_UNCHANGED)
+        {
+            adr += bn;
+            continue;
+        }
+
+        if (bn > 0 && erased[block_no] == BLOCK_UNTOUCHED)
         {
             int r;
 
@@ -365,7 +467,7 @@ urj_flashmem (urj_bus_t *bus, FILE *f, uint32_t addr, int noverify)
             r = flash_driver->erase_block (urj_flash_cfi_array, adr);
             urj_log (URJ_LOG_LEVEL_NORMAL, _("erasing block %d: %d\n"),
                      block_no, r);
-            erased[block_no] = 1;
+            erased[block_no] = BLOCK_ERASED;
         }
 
         for (bc = 0; bc < bn; bc += flash_driver->bus_width)
@@ -421,12 +523,16 @@ urj_flashmem (urj_bus_t *bus, FILE *f, uint32_t addr, int noverify)
         uint32_t data, readed;
         uint8_t b[BSIZE];
         int bc = 0, bn = 0, btr = BSIZE;
+        int n;
 
         // @@@@ RFHH check error state?
         bn = fread (b, 1, btr, f);
 
-        /* start consecutive read */
-        URJ_BUS_READ_START (bus, adr);
+        /* read back the whole chunk, the bus driver may do so in a burst */
+        n = (bn + flash_driver->bus_width - 1) / flash_driver->bus_width;
+        if (urj_bus_read_block (bus, adr, flash_driver->bus_width,
+                                write_buffer, n) != URJ_STATUS_OK)
+            return URJ_STATUS_FAIL;
 
         for (bc = 0; bc < bn; bc += flash_driver->bus_width)
         {
@@ -447,12 +553,9 @@ urj_flashmem (urj_bus_t *bus, FILE *f, uint32_t addr, int noverify)
                 else
                     data |= b[bc + j] << (j * 8);
 
-            readed = URJ_BUS_READ_NEXT (bus, next_adr);
+            readed = write_buffer[bc / flash_driver->bus_width];
             if (data != readed)
             {
-                /* end consecutive read */
-                (void) URJ_BUS_READ_END (bus);
-
                 urj_error_set (URJ_ERROR_FLASH_PROGRAM,
                                _("addr: 0x%08lX\n verify error:\nread: 0x%08lX\nexpected: 0x%08lX\n"),
                                  (long unsigned) adr, (long unsigned) readed,
@@ -461,11 +564,6 @@ urj_flashmem (urj_bus_t *bus, FILE *f, uint32_t addr, int noverify)
             }
             adr = next_adr;
         }
-
-        /* end consecutive read
-           this wastes one read access but saves us from determining the for-loop
-           finish condition twice within the loop */
-        (void) URJ_BUS_READ_END (bus);
     }
     urj_log (URJ_LOG_LEVEL_NORMAL, _("addr: 0x%08lX\nDone.\n"),
              (long unsigned) adr - flash_driver->bus_width);
@@ -473,6 +571,18 @@ urj_flashmem (urj_bus_t *bus, FILE *f, uint32_t addr, int noverify)
     return URJ_STATUS_OK;
 }
 
+int
+urj_flashmem (urj_bus_t *bus, FILE *f, uint32_t addr, int noverify)
+{
+    return flashmem (bus, f, addr, noverify, 0);
+}
+
+int
+urj_flashmem_diff (urj_bus_t *bus, FILE *f, uint32_t addr, int noverify)
+{
+    return flashmem (bus, f, addr, noverify, 1);
+}
+
 int
 urj_flasherase (urj_bus_t *bus, uint32_t addr, uint32_t number)
 {
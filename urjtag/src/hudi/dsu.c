@@ -68,11 +68,10 @@ static uint32_t dsu_readIR(urj_chain_t *chain)
 
 static void dsu_writeIR(urj_chain_t *chain, int size, unsigned int val)
 {
-  urj_tap_register_t *rwr = urj_tap_register_alloc(size);
+  urj_tap_register_t *rwr = regcache_get(chain, size, REGCACHE_WR);
   urj_tap_register_set_value(rwr, val); 
   urj_tap_capture_ir(chain); 
   urj_tap_shift_register(chain, rwr, NULL, URJ_CHAIN_EXITMODE_IDLE); 
-  urj_tap_register_free(rwr);
 
   /* urj_tap_capture_ir(chain); */
   /* urj_tap_register_set_value(wir, val); */
@@ -84,25 +83,20 @@ static void dsu_writeIR(urj_chain_t *chain, int size, unsigned int val)
 
 static uint64_t dsu_readDR(urj_chain_t *chain, int size, uint64_t wdata)
 {
-  urj_tap_register_t *rwr = urj_tap_register_alloc(size);
-  urj_tap_register_t *rrd = urj_tap_register_fill(urj_tap_register_alloc(size), 0);
-  uint64_t rdata;
+  urj_tap_register_t *rwr = regcache_get(chain, size, REGCACHE_WR);
+  urj_tap_register_t *rrd = regcache_get(chain, size, REGCACHE_RD);
   urj_tap_register_set_value(rwr, wdata);
   urj_tap_capture_dr(chain);
   urj_tap_shift_register(chain, rwr, rrd, URJ_CHAIN_EXITMODE_IDLE);
-  rdata = urj_tap_register_get_value(rrd);
-  urj_tap_register_free(rwr);
-  urj_tap_register_free(rrd);
-  return rdata;
+  return urj_tap_register_get_value(rrd);
 }
 
 static void dsu_writeDR(urj_chain_t *chain, int size, uint64_t wdata)
 {
-  urj_tap_register_t *rwr = urj_tap_register_alloc(size);
+  urj_tap_register_t *rwr = regcache_get(chain, size, REGCACHE_WR);
   urj_tap_register_set_value(rwr, wdata);
   urj_tap_capture_dr(chain);
   urj_tap_shift_register(chain, rwr, NULL, URJ_CHAIN_EXITMODE_IDLE);
-  urj_tap_register_free(rwr);
 }
 
 uint32_t dsu_dpeek(urj_chain_t *chain, int reg)
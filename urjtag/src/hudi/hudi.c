@@ -79,20 +79,25 @@ typedef enum HUDI_STATUS_REGISTER_ID
 #define HUDI_RSDIR_LEN 32
 #define HUDI_WSDIR_LEN 8
 
+#define HUDI_SDDR_LEN  32
+
 static urj_tap_register_t *rsdir  = NULL;
 static urj_tap_register_t *wsdir  = NULL;
+static urj_tap_register_t *wsddr  = NULL;
 
 void hudi_init(void)
 {
   if (rsdir  == NULL) rsdir  = urj_tap_register_fill(urj_tap_register_alloc(HUDI_RSDIR_LEN), 0);
   if (wsdir  == NULL) wsdir  = urj_tap_register_fill(urj_tap_register_alloc(HUDI_WSDIR_LEN), 0);
+  if (wsddr  == NULL) wsddr  = urj_tap_register_fill(urj_tap_register_alloc(HUDI_SDDR_LEN), 0);
 }
 
 void hudi_free(void)
 {
   if (rsdir  != NULL) urj_tap_register_free(rsdir);
   if (wsdir  != NULL) urj_tap_register_free(wsdir);
-  rsdir = wsdir = NULL;
+  if (wsddr  != NULL) urj_tap_register_free(wsddr);
+  rsdir = wsdir = wsddr = NULL;
 }
 
 static void hudi_test_logic_reset(urj_chain_t *chain)
@@ -110,7 +115,7 @@ void hudi_run_test_idle(urj_chain_t *chain)
 
 uint32_t hudi_readSDIR(urj_chain_t *chain)
 {
-  urj_tap_register_t *ones = urj_tap_register_fill(urj_tap_register_alloc(HUDI_RSDIR_LEN), 1);
+  urj_tap_register_t *ones = urj_tap_register_fill(regcache_get(chain, HUDI_RSDIR_LEN, REGCACHE_WR), 1);
   urj_tap_capture_ir(chain);
   urj_tap_shift_register(chain, ones, rsdir, URJ_CHAIN_EXITMODE_IDLE);
   hudi_sdmode_locked = 1;
@@ -218,37 +223,67 @@ void hudi_initialState(urj_chain_t *chain)
 
 static uint32_t hudi_readSDDRorSDSR(urj_chain_t *chain, uint32_t wdata)
 {
-  urj_tap_register_t *rwr = urj_tap_register_alloc(32);
-  urj_tap_register_t *rrd = urj_tap_register_fill(urj_tap_register_alloc(32), 0);
-  uint32_t rdata;
+  urj_tap_register_t *rwr = regcache_get(chain, HUDI_SDDR_LEN, REGCACHE_WR);
+  urj_tap_register_t *rrd = regcache_get(chain, HUDI_SDDR_LEN, REGCACHE_RD);
   urj_tap_register_set_value(rwr,wdata);
   urj_tap_capture_dr(chain);
   urj_tap_shift_register(chain, rwr, rrd, URJ_CHAIN_EXITMODE_IDLE);
-  rdata = urj_tap_register_get_value(rrd);
-  urj_tap_register_free(rwr);
-  urj_tap_register_free(rrd);
-  return rdata;
+  return urj_tap_register_get_value(rrd);
 }
 
-static void hudi_writeSDDRorSDSR(urj_chain_t *chain, uint32_t wdata)
+static void hudi_update_sdmode(uint32_t wdata)
 {
-  urj_tap_register_t *rwr = urj_tap_register_alloc(32);
-  urj_tap_register_set_value(rwr, wdata);
-  urj_tap_capture_dr(chain);
-  urj_tap_shift_register(chain, rwr, NULL, URJ_CHAIN_EXITMODE_IDLE);
-  urj_tap_register_free(rwr);
   if (hudi_sdmode_locked == 0) {
     if (hudi_sdmode == 1) hudi_sdmode = 0;
     else hudi_sdmode = (wdata & 1);
   }
 }
 
+static void hudi_writeSDDRorSDSR(urj_chain_t *chain, uint32_t wdata)
+{
+  urj_tap_register_t *rwr = regcache_get(chain, HUDI_SDDR_LEN, REGCACHE_WR);
+  urj_tap_register_set_value(rwr, wdata);
+  urj_tap_capture_dr(chain);
+  urj_tap_shift_register(chain, rwr, NULL, URJ_CHAIN_EXITMODE_IDLE);
+  hudi_update_sdmode(wdata);
+}
+
+/* queue a SDDR write without flushing the cable, the caller flushes */
+static void hudi_defer_writeSDDR(urj_chain_t *chain, uint32_t wdata)
+{
+  if (hudi_sdmode == 0) hudi_initialState(chain);
+  urj_tap_register_set_value(wsddr, wdata);
+  urj_tap_capture_dr(chain);
+  urj_tap_defer_shift_register(chain, wsddr, NULL, URJ_CHAIN_EXITMODE_IDLE);
+  hudi_update_sdmode(wdata);
+}
+
 uint32_t hudi_readSDDR(urj_chain_t *chain, uint32_t wdata)
 {
   if (hudi_sdmode == 0) hudi_initialState(chain);
   return hudi_readSDDRorSDSR(chain,wdata);
 }
 
+/* read n SDDR words, all scans are queued and flushed at once */
+static void hudi_readSDDR_block(urj_chain_t *chain, uint32_t n, uint32_t *data)
+{
+  urj_tap_register_t *rwr = regcache_get(chain, HUDI_SDDR_LEN, REGCACHE_WR);
+  urj_tap_register_t *rrd = regcache_get(chain, HUDI_SDDR_LEN, REGCACHE_RD);
+  uint32_t i;
+
+  if (hudi_sdmode == 0) hudi_initialState(chain);
+
+  urj_tap_register_set_value(rwr, 0);
+  for(i=0; i<n; i++) {
+    urj_tap_capture_dr(chain);
+    urj_tap_defer_shift_register(chain, rwr, rrd, URJ_CHAIN_EXITMODE_IDLE);
+  }
+  for(i=0; i<n; i++) {
+    urj_tap_shift_register_output(chain, rwr, rrd, URJ_CHAIN_EXITMODE_IDLE);
+    data[i] = urj_tap_register_get_value(rrd);
+  }
+}
+
 uint32_t hudi_readSDSR(urj_chain_t *chain)
 {
   if (hudi_sdmode == 1) {
@@ -300,36 +335,51 @@ void hudi_bootSoftReset(urj_chain_t *chain)
   usleep(20);
 }
 
+#define HUDI_STATUS_SCANS 10
+
+static const uint32_t hudi_status_codes[HUDI_STATUS_SCANS] = {
+  HUDI_CODE_IBUS, HUDI_CODE_SR,     HUDI_CODE_FPSCR, HUDI_CODE_CMF,  HUDI_CODE_PTEH,
+  HUDI_CODE_CCR,  HUDI_CODE_SBTYPE, HUDI_CODE_SBUS,  HUDI_CODE_EBUS, HUDI_CODE_FRQCR,
+};
+
 void hudi_readInternalStatus(urj_chain_t *chain, uint32_t *data)
 {
-  uint32_t temp;
-  
+  urj_tap_register_t *rwr = regcache_get(chain, HUDI_SDDR_LEN, REGCACHE_WR);
+  urj_tap_register_t *rrd = regcache_get(chain, HUDI_SDDR_LEN, REGCACHE_RD);
+  uint32_t raw[HUDI_STATUS_SCANS];
+  int i;
+
   hudi_writeSDIR_InternalStatusReadStart(chain);
- 
-  data[IBUS]    = hudi_readSDDR(chain, HUDI_CODE_IBUS   );
-  data[SR]      = hudi_readSDDR(chain, HUDI_CODE_SR     );
-  data[FPSCR]   = hudi_readSDDR(chain, HUDI_CODE_FPSCR  );
-  temp          = hudi_readSDDR(chain, HUDI_CODE_CMF    );
-  data[CMF]     = temp & 0x3f;
-  data[SCMF]    = (temp >> 6) & 0xf;
-  temp          = hudi_readSDDR(chain, HUDI_CODE_PTEH   );
-  data[PTEH]    = temp & 0xff;
-  data[EXPEVT]  = (temp >>  8) & 0xfff;
-  data[INTEVT]  = ((temp >> 20) & 0xfff) << 2;
-  temp          = hudi_readSDDR(chain, HUDI_CODE_CCR    );
-  data[CCR]     = temp & 0x7f;
-  data[MMUCRAT] = (temp >> 7) & 0x1;
-  temp          = hudi_readSDDR(chain, HUDI_CODE_SBTYPE );
-  data[SBTYPE]  = temp & 0xf;
-  data[EBTYPE]  = (temp >> 4) & 0x7f;
-  data[SBUS]    = hudi_readSDDR(chain, HUDI_CODE_SBUS   );
-  temp          = hudi_readSDDR(chain, HUDI_CODE_EBUS   );
-  data[EBUS]    = temp & 0x1fffffff;
-  temp          = hudi_readSDDR(chain, HUDI_CODE_FRQCR  );
-  data[FRQCR]   = temp & 0xfff;
-  data[STATUS]  = (temp >> 12) & 0x3;
+
+  // queue all status scans, the first output request flushes them at once
+  for(i=0; i<HUDI_STATUS_SCANS; i++) {
+    urj_tap_register_set_value(rwr, hudi_status_codes[i]);
+    urj_tap_capture_dr(chain);
+    urj_tap_defer_shift_register(chain, rwr, rrd, URJ_CHAIN_EXITMODE_IDLE);
+  }
+  for(i=0; i<HUDI_STATUS_SCANS; i++) {
+    urj_tap_shift_register_output(chain, rwr, rrd, URJ_CHAIN_EXITMODE_IDLE);
+    raw[i] = urj_tap_register_get_value(rrd);
+  }
 
   hudi_writeSDIR_InternalStatusReadEnd(chain);
+
+  data[IBUS]    = raw[0];
+  data[SR]      = raw[1];
+  data[FPSCR]   = raw[2];
+  data[CMF]     = raw[3] & 0x3f;
+  data[SCMF]    = (raw[3] >> 6) & 0xf;
+  data[PTEH]    = raw[4] & 0xff;
+  data[EXPEVT]  = (raw[4] >>  8) & 0xfff;
+  data[INTEVT]  = ((raw[4] >> 20) & 0xfff) << 2;
+  data[CCR]     = raw[5] & 0x7f;
+  data[MMUCRAT] = (raw[5] >> 7) & 0x1;
+  data[SBTYPE]  = raw[6] & 0xf;
+  data[EBTYPE]  = (raw[6] >> 4) & 0x7f;
+  data[SBUS]    = raw[7];
+  data[EBUS]    = raw[8] & 0x1fffffff;
+  data[FRQCR]   = raw[9] & 0xfff;
+  data[STATUS]  = (raw[9] >> 12) & 0x3;
 }
 
 void hudi_printInternalStatus(urj_chain_t *chain)
@@ -394,6 +444,13 @@ struct overlay_segment {
 #define STDI_OVERLAY_DETACH          25
 #define STDI_OVERLAY_L2CACHE_PURGE   26
 
+#define STDI_ASERAM_BUFFER     0xfc0002a0
+#define STDI_ASERAM_SIGNAL     0xfc0003fc
+#define STDI_DUMP_CHUNK_LONGS  ((STDI_ASERAM_SIGNAL - STDI_ASERAM_BUFFER) >> 2)
+#define STDI_DUMP_POLL_MAX     10000
+
+#define HUDI_SDSR_SDTRF        0x1
+
 static char* hudi_stdi_overlay_name(int n)
 {
   switch(n) {
@@ -471,9 +528,11 @@ static int hudi_stdi_write_aseram(urj_chain_t *chain, uint32_t boot, uint32_t si
   sdar  = (end << 16) | start;
   hudi_writeSDIR_AseramWrite(chain);
 
-  hudi_writeSDDR(chain, sdar);
+  /* the whole segment goes out in one cable flush */
+  hudi_defer_writeSDDR(chain, sdar);
   for(;size--;)
-    hudi_writeSDDR(chain, *code++);
+    hudi_defer_writeSDDR(chain, *code++);
+  urj_tap_chain_flush(chain);
 
   hudi_writeSDIR_Bypass(chain);
   return 0;
@@ -509,13 +568,13 @@ static int hudi_stdi_start_overlay(urj_chain_t *chain, int n, uint32_t sig, uint
   }
 
   if (size && buf) {
-    if (hudi_stdi_write_aseram(chain, 0xfc0002a0, size, buf)) {
+    if (hudi_stdi_write_aseram(chain, STDI_ASERAM_BUFFER, size, buf)) {
       urj_error_set (URJ_ERROR_SYNTAX, "unable to send buffer %p/%d to st40", buf, size);
       return 1;
     }
   }
 
-  if (hudi_stdi_write_aseram(chain, 0xfc0003fc, 1, &sig)) {
+  if (hudi_stdi_write_aseram(chain, STDI_ASERAM_SIGNAL, 1, &sig)) {
     urj_error_set (URJ_ERROR_SYNTAX, "unable to send signal %08x to st40", sig);
     return 1;
   }
@@ -524,6 +583,99 @@ static int hudi_stdi_start_overlay(urj_chain_t *chain, int n, uint32_t sig, uint
   return 0;
 }
 
+static int hudi_stdi_wait_sdtrf(urj_chain_t *chain)
+{
+  int i;
+  for(i=0; i<STDI_DUMP_POLL_MAX; i++)
+    if ((hudi_readSDSR(chain) & HUDI_SDSR_SDTRF) == 0)
+      return 0;
+  return 1;
+}
+
+static int hudi_stdi_peek_longs(urj_chain_t *chain, uint32_t addr, uint32_t n, uint32_t *data)
+{
+  uint32_t args[2];
+
+  args[0] = addr;
+  args[1] = n;
+  if (hudi_stdi_start_overlay(chain, STDI_OVERLAY_PEEK_LONGS, STDI_OVERLAY_PEEK_LONGS, 2, args))
+    return 1;
+
+  if (hudi_stdi_wait_sdtrf(chain)) {
+    urj_error_set (URJ_ERROR_TIMEOUT, "st40 did not fill aseram buffer at %08x", addr);
+    return 1;
+  }
+
+  hudi_readSDDR_block(chain, n, data);
+
+  return 0;
+}
+
+int hudi_stdi_dump(urj_chain_t *chain, FILE *f, uint32_t addr, uint32_t len)
+{
+  uint32_t  data[STDI_DUMP_CHUNK_LONGS];
+  uint8_t   b[STDI_DUMP_CHUNK_LONGS << 2];
+  uint32_t  n, i, bc, skip;
+
+  if (stdi_overlays_loaded == 0 || stdi_overlays[STDI_OVERLAY_PEEK_LONGS].code == NULL) {
+    urj_error_set (URJ_ERROR_ILLEGAL_STATE, "peek longs overlay not loaded. run stdi file first.");
+    return URJ_STATUS_FAIL;
+  }
+
+  if (len == 0) {
+    urj_error_set (URJ_ERROR_INVALID, "length is 0");
+    return URJ_STATUS_FAIL;
+  }
+
+  urj_log (URJ_LOG_LEVEL_NORMAL, "address: 0x%08lX\n", (long unsigned) addr);
+  urj_log (URJ_LOG_LEVEL_NORMAL, "length:  0x%08lX\n", (long unsigned) len);
+
+  /* the overlay reads whole longs, leave out the bytes before addr */
+  skip = addr & 3;
+  addr &= ~3;
+
+  if (hudi_stdi_load_overlay(chain, STDI_OVERLAY_PEEK_LONGS)) {
+    urj_error_set (URJ_ERROR_ILLEGAL_STATE, "unable to send overlay %s to st40", hudi_stdi_overlay_name(STDI_OVERLAY_PEEK_LONGS));
+    return URJ_STATUS_FAIL;
+  }
+
+  while (len) {
+    n = (skip + len + 3) >> 2;
+    if (n > STDI_DUMP_CHUNK_LONGS)
+      n = STDI_DUMP_CHUNK_LONGS;
+
+    if (hudi_stdi_peek_longs(chain, addr, n, data))
+      return URJ_STATUS_FAIL;
+
+    /* st40 runs little endian, keep the dump byte exact */
+    for(i=0, bc=0; i<n; i++) {
+      b[bc++] = data[i]       & 0xff;
+      b[bc++] = data[i] >>  8 & 0xff;
+      b[bc++] = data[i] >> 16 & 0xff;
+      b[bc++] = data[i] >> 24 & 0xff;
+    }
+    addr += bc;
+    bc   -= skip;
+    if (bc > len)
+      bc = len;
+
+    if (fwrite(b + skip, bc, 1, f) != 1) {
+      urj_error_set (URJ_ERROR_FILEIO, "fwrite fails");
+      urj_error_state.sys_errno = ferror(f);
+      clearerr(f);
+      return URJ_STATUS_FAIL;
+    }
+
+    len  -= bc;
+    skip  = 0;
+    urj_log (URJ_LOG_LEVEL_NORMAL, "addr: 0x%08lX\r", (long unsigned) addr);
+  }
+
+  urj_log (URJ_LOG_LEVEL_NORMAL, "\nDone.\n");
+
+  return URJ_STATUS_OK;
+}
+
 int hudi_stdi_detach(urj_chain_t *chain)
 {
   printf("%s :: not yet!\n", __FUNCTION__);
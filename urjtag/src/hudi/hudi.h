@@ -17,6 +17,7 @@
  */
 
 #include <stdint.h>
+#include <stdio.h>
 #include <urjtag/chain.h>
 
 void     hudi_init(void);
@@ -51,3 +52,4 @@ void     hudi_printInternalStatus(urj_chain_t *chain);
 int      hudi_load_stdi_file(const char* filename, size_t offset);
 int      hudi_stdi_attach(urj_chain_t *chain);
 int      hudi_stdi_detach(urj_chain_t *chain);
+int      hudi_stdi_dump(urj_chain_t *chain, FILE *f, uint32_t addr, uint32_t len);
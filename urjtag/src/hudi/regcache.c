@@ -0,0 +1,93 @@
+/* Copyright (C) 2010 urjtag.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307, USA.
+ */
+
+#include <sysdep.h>
+
+#include <stdlib.h>
+
+#include <urjtag/chain.h>
+#include <urjtag/tap_register.h>
+
+//
+// scratch scan registers shared by tmc, hudi and dsu, reused across
+// scans instead of allocated per access. entries are keyed by chain,
+// register length and slot (write or read side of the same scan).
+//
+
+#define REGCACHE_ENTRIES 16
+
+struct regcache_entry {
+  urj_chain_t        *chain;
+  int                 len;
+  int                 slot;
+  urj_tap_register_t *reg;
+};
+
+static struct regcache_entry regcache[REGCACHE_ENTRIES];
+static int                   regcache_victim = 0;
+static int                   regcache_last   = -1;
+
+urj_tap_register_t *regcache_get(urj_chain_t *chain, int len, int slot)
+{
+  struct regcache_entry *e;
+  int i;
+
+  for(i=0; i<REGCACHE_ENTRIES; i++) {
+    e = &regcache[i];
+    if (e->reg && e->chain == chain && e->len == len && e->slot == slot) {
+      regcache_last = i;
+      return e->reg;
+    }
+  }
+
+  for(i=0; i<REGCACHE_ENTRIES; i++)
+    if (regcache[i].reg == NULL)
+      break;
+
+  if (i == REGCACHE_ENTRIES) {
+    // all in use, recycle round robin but keep the other half of a
+    // write/read pair that was just handed out
+    if (regcache_victim == regcache_last)
+      regcache_victim = (regcache_victim + 1) % REGCACHE_ENTRIES;
+    i = regcache_victim;
+    regcache_victim = (regcache_victim + 1) % REGCACHE_ENTRIES;
+    urj_tap_register_free(regcache[i].reg);
+    regcache[i].reg = NULL;
+  }
+
+  e = &regcache[i];
+  e->reg = urj_tap_register_alloc(len);
+  if (e->reg == NULL)
+    return NULL;
+  e->chain = chain;
+  e->len   = len;
+  e->slot  = slot;
+  regcache_last = i;
+  return e->reg;
+}
+
+void regcache_free(void)
+{
+  int i;
+  for(i=0; i<REGCACHE_ENTRIES; i++) {
+    if (regcache[i].reg) urj_tap_register_free(regcache[i].reg);
+    regcache[i].reg = NULL;
+  }
+  regcache_victim = 0;
+  regcache_last   = -1;
+}
@@ -0,0 +1,26 @@
+/* Copyright (C) 2010 urjtag.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307, USA.
+ */
+
+#include <urjtag/chain.h>
+#include <urjtag/tap_register.h>
+
+#define REGCACHE_WR 0
+#define REGCACHE_RD 1
+
+urj_tap_register_t *regcache_get(urj_chain_t *chain, int len, int slot);
+void                regcache_free(void);
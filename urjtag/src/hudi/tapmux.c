@@ -87,6 +87,7 @@ void tmc_free(void)
   if (rir) urj_tap_register_free(rir);
   if (wir) urj_tap_register_free(wir);
   rir = wir = NULL;
+  regcache_free();
 }
 
 void tmc_reset_tmc(urj_chain_t *chain)
@@ -192,25 +193,20 @@ static void tmc_writeIR(urj_chain_t *chain, unsigned int val)
 
 static uint32_t tmc_readDR(urj_chain_t *chain, int size, uint32_t wdata)
 {
-  urj_tap_register_t *rwr = urj_tap_register_alloc(size);
-  urj_tap_register_t *rrd = urj_tap_register_fill(urj_tap_register_alloc(size), 0);
-  uint32_t rdata;
+  urj_tap_register_t *rwr = regcache_get(chain, size, REGCACHE_WR);
+  urj_tap_register_t *rrd = regcache_get(chain, size, REGCACHE_RD);
   urj_tap_register_set_value(rwr, wdata);
   urj_tap_capture_dr(chain);
   urj_tap_shift_register(chain, rwr, rrd, URJ_CHAIN_EXITMODE_IDLE);
-  rdata = urj_tap_register_get_value(rrd);
-  urj_tap_register_free(rwr);
-  urj_tap_register_free(rrd);
-  return rdata;
+  return urj_tap_register_get_value(rrd);
 }
 
 static void tmc_writeDR(urj_chain_t *chain, int size, uint32_t wdata)
 {
-  urj_tap_register_t *rwr = urj_tap_register_alloc(size);
+  urj_tap_register_t *rwr = regcache_get(chain, size, REGCACHE_WR);
   urj_tap_register_set_value(rwr, wdata);
   urj_tap_capture_dr(chain);
   urj_tap_shift_register(chain, rwr, NULL, URJ_CHAIN_EXITMODE_IDLE);
-  urj_tap_register_free(rwr);
 }
 
 #define tmc_printIR(chain,name)     printf("%s(%d) = 0x%08x", name, 5,   tmc_readIR(chain))
@@ -61,6 +61,9 @@ urj_jim_print_sreg (urj_log_level_t ll, urj_jim_shift_reg_t *r)
 static void
 urj_jim_print_tap_state (urj_log_level_t ll, char *rof, urj_jim_device_t *dev)
 {
+    if (ll < urj_log_state.level)
+        return;
+
     urj_log (ll, " tck %s, state=", rof);
     switch (dev->tap_state & 7)
     {
@@ -222,6 +225,182 @@ urj_jim_tck_fall (urj_jim_state_t *s)
     }
 }
 
+/* The register a device shifts in its current state; NULL for BYPASS */
+static urj_jim_shift_reg_t *
+urj_jim_current_sreg (urj_jim_device_t *dev)
+{
+    if (dev->tap_state & 8)
+        return &dev->sreg[0];
+    if (dev->current_dr == 0)
+        return NULL;
+    return &dev->sreg[dev->current_dr];
+}
+
+/*
+ * Shift k (1..32) bits through dev and the devices before it in one step.
+ * Bit j of tdi is the TDI of clock j; the result holds the TDO of dev
+ * before each clock, i.e. what urj_jim_get_tdo() would have returned.
+ *
+ * Each device is a FIFO whose output stream is its TDO followed by the
+ * remaining register bits and then its input stream, so k clocks are a
+ * k-bit right shift of the register with the input inserted at the top.
+ */
+static uint32_t
+urj_jim_shift_word (urj_jim_device_t *dev, uint32_t tdi, int k)
+{
+    urj_jim_shift_reg_t *sr;
+    uint32_t *reg;
+    uint32_t mask = (k == 32) ? 0xFFFFFFFF : ((uint32_t) 1 << k) - 1;
+    uint32_t in, out;
+    int i, nw, p;
+
+    in = (dev->prev != NULL) ? urj_jim_shift_word (dev->prev, tdi, k) : tdi;
+    in &= mask;
+
+    sr = urj_jim_current_sreg (dev);
+    if (sr == NULL)             /* BYPASS */
+    {
+        out = ((in << 1) | (dev->tdo != 0)) & mask;
+        dev->tdo = dev->tdo_buffer = (in >> (k - 1)) & 1;
+        return out;
+    }
+
+    reg = sr->reg;
+    nw = (sr->len + 31) / 32;
+
+    /* bits above len are always zero, so the input lands right above */
+    out = reg[0];
+    if (sr->len < 32)
+        out |= in << sr->len;
+    out = ((out & ~1) | (dev->tdo != 0)) & mask;
+
+    if (k >= sr->len)
+    {
+        /* the whole register is replaced by the last len input bits */
+        reg[0] = (in >> (k - sr->len)) & ((2u << (sr->len - 1)) - 1);
+    }
+    else
+    {
+        for (i = 0; i < nw; i++)
+        {
+            uint64_t w = reg[i];
+
+            if (i + 1 < nw)
+                w |= (uint64_t) reg[i + 1] << 32;
+            reg[i] = (uint32_t) (w >> k);
+        }
+
+        p = sr->len - k;
+        reg[p / 32] |= in << (p % 32);
+        if (p % 32 != 0 && p / 32 + 1 < nw)
+            reg[p / 32 + 1] |= in >> (32 - p % 32);
+    }
+
+    dev->tdo = dev->tdo_buffer = reg[0] & 1;
+
+    return out;
+}
+
+/* All devices stay in the same state when clocked with TMS=0 */
+static int
+urj_jim_tms0_stable (urj_jim_state_t *s)
+{
+    urj_jim_device_t *dev;
+
+    /* keep the per-clock trace when it is asked for */
+    if (urj_log_state.level <= URJ_LOG_LEVEL_DETAIL)
+        return 0;
+
+    for (dev = s->last_device_in_chain; dev; dev = dev->prev)
+        if (next_tap_state[dev->tap_state][0] != dev->tap_state)
+            return 0;
+
+    return 1;
+}
+
+static int
+urj_jim_shifting (urj_jim_state_t *s)
+{
+    urj_jim_tap_state_t st = s->last_device_in_chain->tap_state;
+
+    return st == URJ_JIM_SHIFT_DR || st == URJ_JIM_SHIFT_IR;
+}
+
+void
+urj_jim_transfer (urj_jim_state_t *s, int len, const char *in, char *out)
+{
+    int i, j;
+
+    if (s->last_device_in_chain == NULL)
+    {
+        if (out != NULL)
+            memset (out, 0, len);
+        return;
+    }
+
+    for (i = 0; i < len && !(urj_jim_tms0_stable (s) && urj_jim_shifting (s));
+         i++)
+    {
+        if (out != NULL)
+            out[i] = urj_jim_get_tdo (s);
+        urj_jim_tck_rise (s, 0, in[i]);
+        urj_jim_tck_fall (s);
+    }
+
+    while (i < len)
+    {
+        int k = (len - i < 32) ? len - i : 32;
+        uint32_t tdi = 0, tdo;
+
+        for (j = 0; j < k; j++)
+            if (in[i + j] != 0)
+                tdi |= (uint32_t) 1 << j;
+
+        tdo = urj_jim_shift_word (s->last_device_in_chain, tdi, k);
+
+        if (out != NULL)
+            for (j = 0; j < k; j++)
+                out[i + j] = (tdo >> j) & 1;
+        i += k;
+    }
+}
+
+void
+urj_jim_clock (urj_jim_state_t *s, int tms, int tdi, int n)
+{
+    urj_jim_device_t *dev;
+    int ndev = 0;
+
+    for (dev = s->last_device_in_chain; dev; dev = dev->prev)
+        ndev++;
+
+    while (n > 0)
+    {
+        if (tms == 0 && ndev > 0 && urj_jim_tms0_stable (s))
+        {
+            if (urj_jim_shifting (s))
+            {
+                uint32_t w = tdi ? 0xFFFFFFFF : 0;
+
+                for (; n >= 32; n -= 32)
+                    urj_jim_shift_word (s->last_device_in_chain, w, 32);
+                if (n > 0)
+                    urj_jim_shift_word (s->last_device_in_chain, w, n);
+                return;
+            }
+
+            /* outside Shift only BYPASS devices pass TDI on, so the
+               chain settles after one clock per device */
+            if (n > ndev)
+                n = ndev;
+        }
+
+        urj_jim_tck_rise (s, tms, tdi);
+        urj_jim_tck_fall (s);
+        n--;
+    }
+}
+
 urj_jim_device_t *
 urj_jim_alloc_device (int num_sregs, const int reg_size[])
 {
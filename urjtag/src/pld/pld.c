@@ -198,3 +198,172 @@ urj_pld_write_register (urj_chain_t *chain, uint32_t reg, uint32_t data)
 
     return pld_driver->write_register (&pld, reg, data);
 }
+
+static int
+set_readback_driver (urj_chain_t *chain)
+{
+    urj_part_t *part;
+
+    part = urj_tap_chain_active_part (chain);
+
+    if (part == NULL)
+        return URJ_STATUS_FAIL;
+
+    if (set_pld_driver (chain, part) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    if (pld_driver->readback == NULL)
+    {
+        urj_error_set (URJ_ERROR_UNSUPPORTED,
+                       _("PLD doesn't support this operation"));
+        return URJ_STATUS_FAIL;
+    }
+
+    return URJ_STATUS_OK;
+}
+
+static int
+readback_to_file (void *data, const uint8_t *buf, uint32_t len)
+{
+    FILE *f = data;
+
+    if (fwrite (buf, 1, len, f) != len)
+    {
+        urj_error_IO_set (_("Error writing readback data"));
+        return URJ_STATUS_FAIL;
+    }
+
+    return URJ_STATUS_OK;
+}
+
+int
+urj_pld_readback (urj_chain_t *chain, const char *filename, uint32_t len)
+{
+    FILE *out_file;
+    int result;
+
+    if (len == 0)
+    {
+        urj_error_set (URJ_ERROR_INVALID, _("Readback length is 0"));
+        return URJ_STATUS_FAIL;
+    }
+
+    if (set_readback_driver (chain) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    if ((out_file = fopen (filename, FOPEN_W)) == NULL)
+    {
+        urj_error_IO_set (_("cannot open file '%s'"), filename);
+        return URJ_STATUS_FAIL;
+    }
+
+    result = pld_driver->readback (&pld, len, readback_to_file, out_file);
+
+    if (fclose (out_file) != 0 && result == URJ_STATUS_OK)
+    {
+        urj_error_IO_set (_("Error writing readback data"));
+        result = URJ_STATUS_FAIL;
+    }
+    if (result != URJ_STATUS_OK)
+        remove (filename);
+
+    return result;
+}
+
+struct verify_state
+{
+    FILE *ref_file;
+    FILE *mask_file;
+    uint32_t offset;
+    uint32_t first_mismatch;
+    uint32_t mismatches;
+};
+
+static int
+verify_chunk (void *data, const uint8_t *buf, uint32_t len)
+{
+    struct verify_state *vs = data;
+    uint8_t ref[256];
+    uint8_t mask[256];
+    uint32_t done, n, i;
+    size_t m;
+
+    for (done = 0; done < len; done += n)
+    {
+        n = len - done;
+        if (n > sizeof ref)
+            n = sizeof ref;
+
+        if (fread (ref, 1, n, vs->ref_file) != n)
+        {
+            urj_error_IO_set (_("Error reading reference file"));
+            return URJ_STATUS_FAIL;
+        }
+
+        /* a short mask leaves the remaining bits unmasked */
+        m = 0;
+        if (vs->mask_file != NULL)
+            m = fread (mask, 1, n, vs->mask_file);
+        memset (mask + m, 0, n - m);
+
+        for (i = 0; i < n; i++)
+        {
+            if ((buf[done + i] ^ ref[i]) & ~mask[i])
+            {
+                if (vs->mismatches == 0)
+                    vs->first_mismatch = vs->offset + done + i;
+                vs->mismatches++;
+            }
+        }
+    }
+
+    vs->offset += len;
+
+    return URJ_STATUS_OK;
+}
+
+int
+urj_pld_verify (urj_chain_t *chain, FILE *ref_file, FILE *mask_file)
+{
+    struct verify_state vs;
+    long len;
+
+    if (set_readback_driver (chain) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    if (fseek (ref_file, 0, SEEK_END) != 0
+        || (len = ftell (ref_file)) < 0
+        || fseek (ref_file, 0, SEEK_SET) != 0)
+    {
+        urj_error_IO_set (_("Cannot determine size of reference file"));
+        return URJ_STATUS_FAIL;
+    }
+
+    if (len == 0)
+    {
+        urj_error_set (URJ_ERROR_INVALID, _("Reference file is empty"));
+        return URJ_STATUS_FAIL;
+    }
+
+    vs.ref_file = ref_file;
+    vs.mask_file = mask_file;
+    vs.offset = 0;
+    vs.first_mismatch = 0;
+    vs.mismatches = 0;
+
+    if (pld_driver->readback (&pld, len, verify_chunk, &vs) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    if (vs.mismatches != 0)
+    {
+        urj_error_set (URJ_ERROR_INVALID,
+                       _("Verify failed: %lu bytes differ, first at offset 0x%08lx"),
+                       (unsigned long) vs.mismatches,
+                       (unsigned long) vs.first_mismatch);
+        return URJ_STATUS_FAIL;
+    }
+
+    urj_log (URJ_LOG_LEVEL_NORMAL, _("Verified %ld bytes\n"), len);
+
+    return URJ_STATUS_OK;
+}
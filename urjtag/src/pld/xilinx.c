@@ -30,6 +30,7 @@
 #include <stdlib.h>
 
 #include <urjtag/tap.h>
+#include <urjtag/cable.h>
 #include <urjtag/part.h>
 #include <urjtag/chain.h>
 #include <urjtag/tap_state.h>
@@ -561,16 +562,158 @@ xlx_print_status_xc6s (urj_pld_t *pld)
     return URJ_STATUS_OK;
 }
 
+/* bitstream bytes read and shifted at a time */
+#define XLX_CFG_CHUNK   4096
+
+/* the bits of each byte as register data, MSB first */
+static char xlx_byte_bits[256][8];
+
+static void
+xlx_init_byte_bits (void)
+{
+    int b, j;
+
+    if (xlx_byte_bits[1][7])
+        return;
+
+    for (b = 0; b < 256; b++)
+        for (j = 0; j < 8; j++)
+            xlx_byte_bits[b][j] = (b >> (7 - j)) & 1;
+}
+
+/*
+ * Shift length bytes through the data register of part, in chunks within
+ * one continuous Shift-DR.  The bytes come from bit_file, or are zero if
+ * bit_file is NULL; if sink is not NULL the bytes shifted out of part are
+ * passed to it chunk by chunk.  The other parts of the chain get their
+ * current data registers as in urj_tap_chain_shift_data_registers.
+ */
+static int
+xlx_shift_stream (urj_chain_t *chain, urj_part_t *part, FILE *bit_file,
+                  urj_pld_readback_sink_t sink, void *data, uint32_t length)
+{
+    urj_parts_t *ps = chain->parts;
+    urj_tap_register_t *r, *o = NULL;
+    uint8_t buf[XLX_CFG_CHUNK];
+    int i, me = -1;
+    int status = URJ_STATUS_FAIL;
+
+    for (i = 0; i < ps->len; i++)
+    {
+        if (ps->parts[i]->active_instruction == NULL)
+        {
+            urj_error_set (URJ_ERROR_NO_ACTIVE_INSTRUCTION,
+                           _("Part %d without active instruction"), i);
+            return URJ_STATUS_FAIL;
+        }
+        if (ps->parts[i]->active_instruction->data_register == NULL)
+        {
+            urj_error_set (URJ_ERROR_NO_DATA_REGISTER,
+                           _("Part %d without data register"), i);
+            return URJ_STATUS_FAIL;
+        }
+        if (ps->parts[i] == part)
+            me = i;
+    }
+    if (me < 0 || length == 0)
+    {
+        urj_error_set (URJ_ERROR_PLD,
+                       _("part not in chain or empty bitstream"));
+        return URJ_STATUS_FAIL;
+    }
+
+    r = urj_tap_register_alloc (8 * XLX_CFG_CHUNK);
+    if (r == NULL)
+        return URJ_STATUS_FAIL;
+    if (sink != NULL)
+    {
+        o = urj_tap_register_alloc (8 * XLX_CFG_CHUNK);
+        if (o == NULL)
+            goto fail_free;
+    }
+
+    xlx_init_byte_bits ();
+    if (bit_file == NULL)
+        memset (buf, 0, sizeof buf);
+
+    urj_tap_capture_dr (chain);
+
+    for (i = 0; i < me; i++)
+        urj_tap_defer_shift_register (chain,
+                ps->parts[i]->active_instruction->data_register->in, NULL,
+                URJ_CHAIN_EXITMODE_SHIFT);
+
+    while (length > 0)
+    {
+        uint32_t n = length < XLX_CFG_CHUNK ? length : XLX_CFG_CHUNK;
+        uint32_t u;
+        int exitmode;
+
+        if (bit_file != NULL && fread (buf, 1, n, bit_file) != n)
+        {
+            urj_error_set (URJ_ERROR_PLD, _("Invalid bitfile"));
+            /* leave Shift-DR without updating the register */
+            urj_tap_reset_bypass (chain);
+            goto fail_free;
+        }
+
+        for (u = 0; u < n; u++)
+            memcpy (&r->data[8 * u], xlx_byte_bits[buf[u]], 8);
+        length -= n;
+
+        exitmode = (length == 0 && me + 1 == ps->len)
+                        ? URJ_CHAIN_EXITMODE_IDLE : URJ_CHAIN_EXITMODE_SHIFT;
+
+        r->len = 8 * n;
+        if (sink == NULL)
+        {
+            /* the cable queue takes a copy, so r can be refilled right away;
+               push the chunk out so the queue stays bounded on all cables */
+            urj_tap_defer_shift_register (chain, r, NULL, exitmode);
+            urj_tap_cable_flush (chain->cable, URJ_TAP_CABLE_TO_OUTPUT);
+            continue;
+        }
+
+        o->len = 8 * n;
+        urj_tap_shift_register (chain, r, o, exitmode);
+
+        /* the configuration data comes out MSB first */
+        memset (buf, 0, n);
+        for (u = 0; u < 8 * n; u++)
+            if (o->data[u] & 1)
+                buf[u / 8] |= 0x80 >> (u % 8);
+        if (sink (data, buf, n) != URJ_STATUS_OK)
+        {
+            urj_tap_reset_bypass (chain);
+            goto fail_free;
+        }
+        if (bit_file == NULL)
+            memset (buf, 0, n);
+    }
+
+    for (i = me + 1; i < ps->len; i++)
+        urj_tap_defer_shift_register (chain,
+                ps->parts[i]->active_instruction->data_register->in, NULL,
+                (i + 1 == ps->len) ? URJ_CHAIN_EXITMODE_IDLE
+                                   : URJ_CHAIN_EXITMODE_SHIFT);
+    urj_tap_cable_flush (chain->cable, URJ_TAP_CABLE_TO_OUTPUT);
+
+    status = URJ_STATUS_OK;
+
+ fail_free:
+    if (o != NULL)
+        urj_tap_register_free (o);
+    urj_tap_register_free (r);
+
+    return status;
+}
+
 static int
 xlx_configure (urj_pld_t *pld, FILE *bit_file)
 {
     urj_chain_t *chain = pld->chain;
     urj_part_t *part = pld->part;
-    urj_part_instruction_t *i;
     xlx_bitstream_t *bs;
-    uint32_t u;
-    int dr_len;
-    char *dr_data;
     int status = URJ_STATUS_OK;
 
     /* set all devices in bypass mode */
@@ -583,8 +726,8 @@ xlx_configure (urj_pld_t *pld, FILE *bit_file)
         goto fail;
     }
 
-    /* parse bit file */
-    if (xlx_bitstream_load_bit (bit_file, bs) != URJ_STATUS_OK)
+    /* parse the header, the bitstream is streamed from the file */
+    if (xlx_bitstream_open_bit (bit_file, bs) != URJ_STATUS_OK)
     {
         urj_error_set (URJ_ERROR_PLD, _("Invalid bitfile"));
 
@@ -599,29 +742,6 @@ xlx_configure (urj_pld_t *pld, FILE *bit_file)
     urj_log (URJ_LOG_LEVEL_NORMAL, _("\tTime: %s\n"), bs->time);
     urj_log (URJ_LOG_LEVEL_NORMAL, _("\tBitstream length: %d\n"), bs->length);
 
-    dr_len = bs->length * 8;
-
-    if (xlx_instruction_resize_dr (part, "CFG_IN", "CFG_DR", dr_len)
-            != URJ_STATUS_OK)
-        return URJ_STATUS_FAIL;
-
-    i = urj_part_find_instruction (part, "CFG_IN");
-
-    /* copy data into shift register */
-    dr_data = i->data_register->in->data;
-    for (u = 0; u < bs->length; u++)
-    {
-        /* flip bits */
-        dr_data[8*u+0] = (bs->data[u] & 0x80) ? 1 : 0;
-        dr_data[8*u+1] = (bs->data[u] & 0x40) ? 1 : 0;
-        dr_data[8*u+2] = (bs->data[u] & 0x20) ? 1 : 0;
-        dr_data[8*u+3] = (bs->data[u] & 0x10) ? 1 : 0;
-        dr_data[8*u+4] = (bs->data[u] & 0x08) ? 1 : 0;
-        dr_data[8*u+5] = (bs->data[u] & 0x04) ? 1 : 0;
-        dr_data[8*u+6] = (bs->data[u] & 0x02) ? 1 : 0;
-        dr_data[8*u+7] = (bs->data[u] & 0x01) ? 1 : 0;
-    }
-
     if (xlx_set_ir_and_shift (chain, part, "JPROGRAM") != URJ_STATUS_OK)
     {
         status = URJ_STATUS_FAIL;
@@ -647,7 +767,12 @@ xlx_configure (urj_pld_t *pld, FILE *bit_file)
         goto fail_free;
     }
 
-    urj_tap_chain_shift_data_registers (chain, 0);
+    if (xlx_shift_stream (chain, part, bit_file, NULL, NULL, bs->length)
+            != URJ_STATUS_OK)
+    {
+        status = URJ_STATUS_FAIL;
+        goto fail_free;
+    }
 
     if (xlx_set_ir_and_shift (chain, part, "JSTART") != URJ_STATUS_OK)
     {
@@ -684,6 +809,224 @@ xlx_reconfigure (urj_pld_t *pld)
     return URJ_STATUS_OK;
 }
 
+/*
+ * Configuration readback: set up a frame data read through CFG_IN, then
+ * stream the data out of CFG_OUT.  The packets follow the 16 bit
+ * (Spartan 3A/6) and 32 bit (Virtex 4) configuration packet formats.
+ */
+static int
+xlx_readback_16 (urj_pld_t *pld, uint32_t len, int sync_5566,
+                 urj_pld_readback_sink_t sink, void *data)
+{
+    urj_chain_t *chain = pld->chain;
+    urj_part_t *part = pld->part;
+    uint32_t words = (len + 1) / 2;
+
+    if (xlx_instruction_resize_dr (part, "CFG_IN", "CFG_DR", 16)
+            != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+    if (xlx_instruction_resize_dr (part, "CFG_OUT", "CFG_DR", 16)
+            != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    /* set all devices in bypass mode */
+    urj_tap_reset_bypass (chain);
+
+    if (xlx_set_ir_and_shift (chain, part, "CFG_IN") != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    urj_tap_capture_dr (chain);
+    /* sync */
+    xlx_set_dr_and_shift (chain, part, flip16 (0xffff),
+                          URJ_CHAIN_EXITMODE_SHIFT);
+    xlx_set_dr_and_shift (chain, part, flip16 (0xaa99),
+                          URJ_CHAIN_EXITMODE_SHIFT);
+    if (sync_5566)
+        xlx_set_dr_and_shift (chain, part, flip16 (0x5566),
+                              URJ_CHAIN_EXITMODE_SHIFT);
+    /* noop */
+    xlx_set_dr_and_shift (chain, part, flip16 (0x2000),
+                          URJ_CHAIN_EXITMODE_SHIFT);
+    /* CMD = RCFG */
+    xlx_set_dr_and_shift (chain, part, flip16 (0x30a1),
+                          URJ_CHAIN_EXITMODE_SHIFT);
+    xlx_set_dr_and_shift (chain, part, flip16 (0x0004),
+                          URJ_CHAIN_EXITMODE_SHIFT);
+    /* FAR_MAJ, FAR_MIN = 0 */
+    xlx_set_dr_and_shift (chain, part, flip16 (0x3022),
+                          URJ_CHAIN_EXITMODE_SHIFT);
+    xlx_set_dr_and_shift (chain, part, flip16 (0x0000),
+                          URJ_CHAIN_EXITMODE_SHIFT);
+    xlx_set_dr_and_shift (chain, part, flip16 (0x0000),
+                          URJ_CHAIN_EXITMODE_SHIFT);
+    /* type 2 packet, read FDRO */
+    xlx_set_dr_and_shift (chain, part, flip16 (0x4880),
+                          URJ_CHAIN_EXITMODE_SHIFT);
+    xlx_set_dr_and_shift (chain, part, flip16 (words >> 16),
+                          URJ_CHAIN_EXITMODE_SHIFT);
+    xlx_set_dr_and_shift (chain, part, flip16 (words & 0xffff),
+                          URJ_CHAIN_EXITMODE_SHIFT);
+    /* noop */
+    xlx_set_dr_and_shift (chain, part, flip16 (0x2000),
+                          URJ_CHAIN_EXITMODE_SHIFT);
+    xlx_set_dr_and_shift (chain, part, flip16 (0x2000),
+                          URJ_CHAIN_EXITMODE_IDLE);
+
+    if (xlx_set_ir_and_shift (chain, part, "CFG_OUT") != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    if (xlx_shift_stream (chain, part, NULL, sink, data, len)
+            != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    urj_tap_reset_bypass (chain);
+    urj_tap_chain_flush (chain);
+
+    return URJ_STATUS_OK;
+}
+
+static int
+xlx_readback_xc3s (urj_pld_t *pld, uint32_t len,
+                   urj_pld_readback_sink_t sink, void *data)
+{
+    return xlx_readback_16 (pld, len, 0, sink, data);
+}
+
+static int
+xlx_readback_xc6s (urj_pld_t *pld, uint32_t len,
+                   urj_pld_readback_sink_t sink, void *data)
+{
+    return xlx_readback_16 (pld, len, 1, sink, data);
+}
+
+static int
+xlx_readback_xc4v (urj_pld_t *pld, uint32_t len,
+                   urj_pld_readback_sink_t sink, void *data)
+{
+    urj_chain_t *chain = pld->chain;
+    urj_part_t *part = pld->part;
+    uint32_t words = (len + 3) / 4;
+
+    if (words > 0x07ffffff)
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_BOUNDS,
+                       _("Readback length too large"));
+        return URJ_STATUS_FAIL;
+    }
+
+    if (xlx_instruction_resize_dr (part, "CFG_IN", "CFG_DR", 32)
+            != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+    if (xlx_instruction_resize_dr (part, "CFG_OUT", "CFG_DR", 32)
+            != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    /* set all devices in bypass mode */
+    urj_tap_reset_bypass (chain);
+
+    if (xlx_set_ir_and_shift (chain, part, "CFG_IN") != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    urj_tap_capture_dr (chain);
+    /* sync */
+    xlx_set_dr_and_shift (chain, part, flip32 (0xffffffff),
+                          URJ_CHAIN_EXITMODE_SHIFT);
+    xlx_set_dr_and_shift (chain, part, flip32 (0xaa995566),
+                          URJ_CHAIN_EXITMODE_SHIFT);
+    /* noop */
+    xlx_set_dr_and_shift (chain, part, flip32 (0x20000000),
+                          URJ_CHAIN_EXITMODE_SHIFT);
+    /* CMD = RCFG */
+    xlx_set_dr_and_shift (chain, part, flip32 (0x30008001),
+                          URJ_CHAIN_EXITMODE_SHIFT);
+    xlx_set_dr_and_shift (chain, part, flip32 (0x00000004),
+                          URJ_CHAIN_EXITMODE_SHIFT);
+    /* FAR = 0 */
+    xlx_set_dr_and_shift (chain, part, flip32 (0x30002001),
+                          URJ_CHAIN_EXITMODE_SHIFT);
+    xlx_set_dr_and_shift (chain, part, flip32 (0x00000000),
+                          URJ_CHAIN_EXITMODE_SHIFT);
+    /* type 1 packet (read FDRO, word count = 0), type 2 packet */
+    xlx_set_dr_and_shift (chain, part, flip32 (0x28006000),
+                          URJ_CHAIN_EXITMODE_SHIFT);
+    xlx_set_dr_and_shift (chain, part, flip32 (0x48000000 | words),
+                          URJ_CHAIN_EXITMODE_SHIFT);
+    /* noop */
+    xlx_set_dr_and_shift (chain, part, flip32 (0x20000000),
+                          URJ_CHAIN_EXITMODE_SHIFT);
+    xlx_set_dr_and_shift (chain, part, flip32 (0x20000000),
+                          URJ_CHAIN_EXITMODE_IDLE);
+
+    if (xlx_set_ir_and_shift (chain, part, "CFG_OUT") != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    if (xlx_shift_stream (chain, part, NULL, sink, data, len)
+            != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    urj_tap_reset_bypass (chain);
+    urj_tap_chain_flush (chain);
+
+    return URJ_STATUS_OK;
+}
+
+/*
+ * Configure, then read the status register back and fail if the device
+ * flagged a CRC error in the bitstream.
+ */
+static int
+xlx_check_configure (urj_pld_t *pld, FILE *bit_file,
+                     int (*read_register) (urj_pld_t *, uint32_t, uint32_t *),
+                     uint32_t reg_stat, uint32_t crc_error, uint32_t done)
+{
+    uint32_t status;
+
+    if (xlx_configure (pld, bit_file) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    if (read_register (pld, reg_stat, &status) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    if (status & crc_error)
+    {
+        urj_error_set (URJ_ERROR_PLD,
+                       _("CRC error in configuration (status 0x%08lx)"),
+                       (unsigned long) status);
+        return URJ_STATUS_FAIL;
+    }
+
+    if (!(status & done))
+        urj_log (URJ_LOG_LEVEL_WARNING,
+                 _("Configuration CRC ok, but DONE is not set (status 0x%08lx)\n"),
+                 (unsigned long) status);
+
+    return URJ_STATUS_OK;
+}
+
+static int
+xlx_configure_xc3s (urj_pld_t *pld, FILE *bit_file)
+{
+    return xlx_check_configure (pld, bit_file, xlx_read_register_xc3s,
+                                XILINX_XC3S_REG_STAT, XC3S_STATUS_CRC_ERROR,
+                                XC3S_STATUS_DONE);
+}
+
+static int
+xlx_configure_xc4v (urj_pld_t *pld, FILE *bit_file)
+{
+    return xlx_check_configure (pld, bit_file, xlx_read_register_xc4v,
+                                XILINX_XC4V_REG_STAT, XC4V_STATUS_CRC_ERROR,
+                                XC4V_STATUS_DONE);
+}
+
+static int
+xlx_configure_xc6s (urj_pld_t *pld, FILE *bit_file)
+{
+    return xlx_check_configure (pld, bit_file, xlx_read_register_xc6s,
+                                XILINX_XC6S_REG_STAT, XC6S_STATUS_CRC_ERROR,
+                                XC6S_STATUS_DONE);
+}
+
 static int
 xlx_detect_xc3s (urj_pld_t *pld)
 {
@@ -754,31 +1097,34 @@ const urj_pld_driver_t urj_pld_xc3s_driver = {
     .name = N_("Xilinx Spartan 3 Family"),
     .detect = xlx_detect_xc3s,
     .print_status = xlx_print_status_xc3s,
-    .configure = xlx_configure,
+    .configure = xlx_configure_xc3s,
     .reconfigure = xlx_reconfigure,
     .read_register = xlx_read_register_xc3s,
     .write_register = xlx_write_register_xc3s,
     .register_width = 2,
+    .readback = xlx_readback_xc3s,
 };
 
 const urj_pld_driver_t urj_pld_xc6s_driver = {
     .name = N_("Xilinx Spartan 6 Family"),
     .detect = xlx_detect_xc6s,
     .print_status = xlx_print_status_xc6s,
-    .configure = xlx_configure,
+    .configure = xlx_configure_xc6s,
     .reconfigure = xlx_reconfigure,
     .read_register = xlx_read_register_xc6s,
     .write_register = xlx_write_register_xc6s,
     .register_width = 2,
+    .readback = xlx_readback_xc6s,
 };
 
 const urj_pld_driver_t urj_pld_xc4v_driver = {
     .name = N_("Xilinx Virtex 4 Family"),
     .detect = xlx_detect_xc4v,
     .print_status = xlx_print_status_xc4v,
-    .configure = xlx_configure,
+    .configure = xlx_configure_xc4v,
     .reconfigure = xlx_reconfigure,
     .read_register = xlx_read_register_xc4v,
     .write_register = xlx_write_register_xc4v,
     .register_width = 2,
+    .readback = xlx_readback_xc4v,
 };
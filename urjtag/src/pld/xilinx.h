@@ -119,6 +119,9 @@ typedef struct {
 } xlx_bitstream_t;
 
 int xlx_bitstream_load_bit (FILE *BIT_FILE, xlx_bitstream_t *bs);
+/* parse the header only; leaves BIT_FILE at the first bitstream byte,
+   bs->data is NULL */
+int xlx_bitstream_open_bit (FILE *BIT_FILE, xlx_bitstream_t *bs);
 xlx_bitstream_t* xlx_bitstream_alloc (void);
 void xlx_bitstream_free (xlx_bitstream_t *bs);
 
@@ -34,7 +34,7 @@
 #include "xilinx.h"
 
 static int
-xlx_read_section (FILE *bit_file, char *id, uint8_t **data, uint32_t *len)
+xlx_read_section_header (FILE *bit_file, char *id, uint32_t *len)
 {
     uint8_t buf[4];
     int lenbytes;
@@ -61,17 +61,11 @@ xlx_read_section (FILE *bit_file, char *id, uint8_t **data, uint32_t *len)
     else
         *len = buf[0] << 24 | buf[1] << 16 | buf[2] << 8 | buf[3];
 
-    /* now allocate memory for data */
-    *data = malloc (*len);
-
-    if (fread (*data, 1, *len, bit_file) != *len)
-        return URJ_STATUS_FAIL;
-
     return URJ_STATUS_OK;
 }
 
 int
-xlx_bitstream_load_bit (FILE *bit_file, xlx_bitstream_t *bs)
+xlx_bitstream_open_bit (FILE *bit_file, xlx_bitstream_t *bs)
 {
     char sid = 0;
     uint8_t *sdata;
@@ -92,28 +86,70 @@ xlx_bitstream_load_bit (FILE *bit_file, xlx_bitstream_t *bs)
     urj_log (URJ_LOG_LEVEL_DEBUG,
              _("Valid xilinx bitfile header found.\n"));
 
-    while (sid != 'e')
+    for (;;)
     {
-        if (xlx_read_section (bit_file, &sid, &sdata, &slen) != URJ_STATUS_OK)
+        if (xlx_read_section_header (bit_file, &sid, &slen) != URJ_STATUS_OK)
             return URJ_STATUS_FAIL;
 
         urj_log (URJ_LOG_LEVEL_DEBUG,
                  _("Read section id=%c len=%d.\n"), sid, slen);
 
+        /* the bitstream itself is left in the file */
+        if (sid == 'e')
+            break;
+
+        if (slen == 0)
+            return URJ_STATUS_FAIL;
+
+        sdata = malloc (slen);
+        if (sdata == NULL)
+        {
+            urj_error_set (URJ_ERROR_OUT_OF_MEMORY, _("malloc(%zu) fails"),
+                           (size_t) slen);
+            return URJ_STATUS_FAIL;
+        }
+        if (fread (sdata, 1, slen, bit_file) != slen)
+        {
+            free (sdata);
+            return URJ_STATUS_FAIL;
+        }
+
         /* make sure that strings are terminated */
-        if (sid != 'e')
-            sdata[slen-1] = '\0';
+        sdata[slen-1] = '\0';
 
         switch (sid)
         {
-            case 'a': bs->design = (char *) sdata; break;
-            case 'b': bs->part_name = (char *) sdata; break;
-            case 'c': bs->date = (char *) sdata; break;
-            case 'd': bs->time = (char *) sdata; break;
-            case 'e': bs->data = sdata; bs->length = slen; break;
+            case 'a': free (bs->design); bs->design = (char *) sdata; break;
+            case 'b': free (bs->part_name); bs->part_name = (char *) sdata; break;
+            case 'c': free (bs->date); bs->date = (char *) sdata; break;
+            case 'd': free (bs->time); bs->time = (char *) sdata; break;
+            default: free (sdata); break;
         }
     }
 
+    bs->data = NULL;
+    bs->length = slen;
+
+    return URJ_STATUS_OK;
+}
+
+int
+xlx_bitstream_load_bit (FILE *bit_file, xlx_bitstream_t *bs)
+{
+    if (xlx_bitstream_open_bit (bit_file, bs) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    bs->data = malloc (bs->length);
+    if (bs->data == NULL)
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, _("malloc(%zu) fails"),
+                       (size_t) bs->length);
+        return URJ_STATUS_FAIL;
+    }
+
+    if (fread (bs->data, 1, bs->length, bit_file) != bs->length)
+        return URJ_STATUS_FAIL;
+
     return URJ_STATUS_OK;
 }
 
@@ -0,0 +1,539 @@
+/****************************************************************************/
+/*                                                                          */
+/*  Module:         jamcache.c                                              */
+/*                                                                          */
+/*  Description:    Cache of preprocessed statements.  urj_jam_get_statement */
+/*                  strips comments, folds white space and converts case    */
+/*                  character by character; the cache keeps its result for  */
+/*                  every file position a statement is read from, so loop  */
+/*                  bodies, procedure calls and jumps are tokenized only    */
+/*                  once.  The whole program is compiled into the cache     */
+/*                  before execution, and the result is saved next to the   */
+/*                  STAPL file so that later runs can skip that pass too.   */
+/*                                                                          */
+/*                  Cache file layout (native byte order, only valid on the */
+/*                  host that wrote it):                                    */
+/*                      header line JAMC_CACHE_HEADER                       */
+/*                      int64_t mtime, int32_t size, int32_t count          */
+/*                      count records of                                    */
+/*                          int32_t start, end, statement, next             */
+/*                          int32_t label length, text length               */
+/*                          label and text characters                       */
+/*                                                                          */
+/****************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include "jamexprt.h"
+#include "jamdefs.h"
+#include "jamexec.h"
+#include "jamcache.h"
+#include "jamutil.h"
+
+#include <urjtag/log.h>
+
+#define JAMC_CACHE_HEADER "UrJTAG STAPL statement cache 1\n"
+
+/* suffix appended to the name of the STAPL file */
+#define JAMC_CACHE_SUFFIX ".cache"
+
+#define JAMC_CACHE_MIN_BUCKETS 1024
+
+typedef struct JAMS_STATEMENT_RECORD
+{
+    struct JAMS_STATEMENT_RECORD *next_record;
+    int32_t start;              /* position the statement is read from */
+    int32_t end;                /* file position after the statement */
+    int32_t statement;          /* position of the first character */
+    int32_t next;               /* position after the semicolon */
+    int32_t label_length;
+    int32_t text_length;
+    char *label;                /* points into the same allocation */
+    char text[1];
+} JAMS_STATEMENT_RECORD;
+
+/****************************************************************************/
+/*                                                                          */
+/*  Global variables                                                        */
+/*                                                                          */
+/****************************************************************************/
+
+static JAMS_STATEMENT_RECORD **urj_jam_statement_cache = NULL;
+
+static int32_t urj_jam_statement_buckets = 0L;
+
+static int32_t urj_jam_statement_count = 0L;
+
+static int32_t urj_jam_cache_program_size = 0L;
+
+/****************************************************************************/
+/*                                                                          */
+
+static JAMS_STATEMENT_RECORD *urj_jam_new_statement_record
+    (int32_t label_length, int32_t text_length)
+/*                                                                          */
+/*  Description:    Allocates a record with room for label and text         */
+/*                                                                          */
+/*  Returns:        pointer to record, or NULL if out of memory             */
+/*                                                                          */
+/****************************************************************************/
+{
+    JAMS_STATEMENT_RECORD *record = (JAMS_STATEMENT_RECORD *)
+        malloc (sizeof (JAMS_STATEMENT_RECORD) + text_length + label_length + 1);
+
+    if (record != NULL)
+    {
+        record->label_length = label_length;
+        record->text_length = text_length;
+        record->label = &record->text[text_length + 1];
+        record->text[text_length] = JAMC_NULL_CHAR;
+        record->label[label_length] = JAMC_NULL_CHAR;
+    }
+
+    return record;
+}
+
+/****************************************************************************/
+/*                                                                          */
+
+static void urj_jam_insert_statement_record (JAMS_STATEMENT_RECORD *record)
+/*                                                                          */
+/*  Description:    Links record into the hash table, doubling the number   */
+/*                  of buckets when the chains get long                     */
+/*                                                                          */
+/*  Returns:        nothing                                                 */
+/*                                                                          */
+/****************************************************************************/
+{
+    int32_t index = 0L;
+
+    if (urj_jam_statement_count >= 2 * urj_jam_statement_buckets)
+    {
+        int32_t buckets = 2 * urj_jam_statement_buckets;
+        JAMS_STATEMENT_RECORD **table = (JAMS_STATEMENT_RECORD **)
+            calloc (buckets, sizeof (JAMS_STATEMENT_RECORD *));
+
+        /* without memory the chains just stay longer */
+        if (table != NULL)
+        {
+            for (index = 0; index < urj_jam_statement_buckets; ++index)
+            {
+                while (urj_jam_statement_cache[index] != NULL)
+                {
+                    JAMS_STATEMENT_RECORD *tmp = urj_jam_statement_cache[index];
+
+                    urj_jam_statement_cache[index] = tmp->next_record;
+                    tmp->next_record = table[tmp->start & (buckets - 1)];
+                    table[tmp->start & (buckets - 1)] = tmp;
+                }
+            }
+            free (urj_jam_statement_cache);
+            urj_jam_statement_cache = table;
+            urj_jam_statement_buckets = buckets;
+        }
+    }
+
+    index = record->start & (urj_jam_statement_buckets - 1);
+    record->next_record = urj_jam_statement_cache[index];
+    urj_jam_statement_cache[index] = record;
+    ++urj_jam_statement_count;
+}
+
+/****************************************************************************/
+/*                                                                          */
+
+JAM_RETURN_TYPE urj_jam_init_statement_cache (int32_t program_size)
+/*                                                                          */
+/*  Description:    Enables the statement cache for a program               */
+/*                                                                          */
+/*  Returns:        JAMC_SUCCESS for success, else JAMC_OUT_OF_MEMORY       */
+/*                                                                          */
+/****************************************************************************/
+{
+    urj_jam_free_statement_cache ();
+
+    urj_jam_statement_cache = (JAMS_STATEMENT_RECORD **)
+        calloc (JAMC_CACHE_MIN_BUCKETS, sizeof (JAMS_STATEMENT_RECORD *));
+
+    if (urj_jam_statement_cache == NULL)
+    {
+        return JAMC_OUT_OF_MEMORY;
+    }
+
+    urj_jam_statement_buckets = JAMC_CACHE_MIN_BUCKETS;
+    urj_jam_cache_program_size = program_size;
+
+    return JAMC_SUCCESS;
+}
+
+/****************************************************************************/
+/*                                                                          */
+
+void urj_jam_free_statement_cache (void)
+/*                                                                          */
+/*  Description:    Frees all records and disables the statement cache      */
+/*                                                                          */
+/*  Returns:        nothing                                                 */
+/*                                                                          */
+/****************************************************************************/
+{
+    int32_t index = 0L;
+
+    if (urj_jam_statement_cache != NULL)
+    {
+        for (index = 0; index < urj_jam_statement_buckets; ++index)
+        {
+            while (urj_jam_statement_cache[index] != NULL)
+            {
+                JAMS_STATEMENT_RECORD *tmp = urj_jam_statement_cache[index];
+
+                urj_jam_statement_cache[index] = tmp->next_record;
+                free (tmp);
+            }
+        }
+        free (urj_jam_statement_cache);
+    }
+
+    urj_jam_statement_cache = NULL;
+    urj_jam_statement_buckets = 0L;
+    urj_jam_statement_count = 0L;
+    urj_jam_cache_program_size = 0L;
+}
+
+/****************************************************************************/
+/*                                                                          */
+
+BOOL urj_jam_lookup_statement
+    (int32_t start, char *statement_buffer, char *label_buffer)
+/*                                                                          */
+/*  Description:    Looks for the statement read from position start.  On   */
+/*                  a hit the buffers and the file positions are set as if  */
+/*                  the statement had been read from the input stream.      */
+/*                                                                          */
+/*  Returns:        true if the statement was found in the cache            */
+/*                                                                          */
+/****************************************************************************/
+{
+    JAMS_STATEMENT_RECORD *record = NULL;
+
+    if (urj_jam_statement_cache == NULL)
+    {
+        return false;
+    }
+
+    for (record =
+         urj_jam_statement_cache[start & (urj_jam_statement_buckets - 1)];
+         record != NULL; record = record->next_record)
+    {
+        if (record->start == start)
+        {
+            break;
+        }
+    }
+
+    if ((record == NULL) || (urj_jam_seek (record->end) != 0))
+    {
+        return false;
+    }
+
+    memcpy (statement_buffer, record->text, record->text_length + 1);
+    memcpy (label_buffer, record->label, record->label_length + 1);
+
+    urj_jam_current_file_position = record->end;
+    urj_jam_current_statement_position = record->statement;
+    urj_jam_next_statement_position = record->next;
+
+    return true;
+}
+
+/****************************************************************************/
+/*                                                                          */
+
+void urj_jam_add_statement
+    (int32_t start, const char *statement_buffer, const char *label_buffer)
+/*                                                                          */
+/*  Description:    Remembers a statement which was just read successfully  */
+/*                  from position start.  Statements ending at the end of   */
+/*                  the file are not cached, as the input stream cannot be  */
+/*                  positioned there.                                       */
+/*                                                                          */
+/*  Returns:        nothing                                                 */
+/*                                                                          */
+/****************************************************************************/
+{
+    JAMS_STATEMENT_RECORD *record = NULL;
+
+    if ((urj_jam_statement_cache == NULL) ||
+        (urj_jam_current_file_position >= urj_jam_cache_program_size))
+    {
+        return;
+    }
+
+    record = urj_jam_new_statement_record ((int32_t) strlen (label_buffer),
+                                           (int32_t) strlen (statement_buffer));
+
+    if (record != NULL)
+    {
+        record->start = start;
+        record->end = urj_jam_current_file_position;
+        record->statement = urj_jam_current_statement_position;
+        record->next = urj_jam_next_statement_position;
+        memcpy (record->text, statement_buffer, record->text_length);
+        memcpy (record->label, label_buffer, record->label_length);
+
+        urj_jam_insert_statement_record (record);
+    }
+}
+
+/****************************************************************************/
+/*                                                                          */
+
+JAM_RETURN_TYPE urj_jam_compile_statements (void)
+/*                                                                          */
+/*  Description:    Reads all statements of the program in sequence, which  */
+/*                  fills the cache.  Statements which are only reached by  */
+/*                  seeking elsewhere are added when they are executed.     */
+/*                                                                          */
+/*  Returns:        JAMC_SUCCESS for success, else appropriate error code   */
+/*                                                                          */
+/****************************************************************************/
+{
+    JAM_RETURN_TYPE status = JAMC_SUCCESS;
+    char *statement_buffer = NULL;
+    char label_buffer[JAMC_MAX_NAME_LENGTH + 1];
+
+    statement_buffer = malloc (JAMC_MAX_STATEMENT_LENGTH + 1024);
+
+    if (statement_buffer == NULL)
+    {
+        return JAMC_OUT_OF_MEMORY;
+    }
+
+    urj_jam_current_file_position = 0L;
+    status = urj_jam_seek (0L);
+
+    while ((status == JAMC_SUCCESS) &&
+           (urj_jam_current_file_position < urj_jam_cache_program_size))
+    {
+        status = urj_jam_get_statement (statement_buffer, label_buffer);
+    }
+
+    /* a program without trailing statement leaves white space at the end */
+    if (status == JAMC_UNEXPECTED_END)
+    {
+        status = JAMC_SUCCESS;
+    }
+
+    free (statement_buffer);
+
+    urj_jam_current_file_position = 0L;
+    urj_jam_current_statement_position = 0L;
+    urj_jam_next_statement_position = 0L;
+    urj_jam_seek (0L);
+
+    return status;
+}
+
+/****************************************************************************/
+/*                                                                          */
+
+static char *urj_jam_cache_file_name (const char *filename)
+/*                                                                          */
+/*  Returns:        malloc'ed name of the cache file, or NULL               */
+/*                                                                          */
+/****************************************************************************/
+{
+    char *name = malloc (strlen (filename) + sizeof JAMC_CACHE_SUFFIX);
+
+    if (name != NULL)
+    {
+        strcpy (name, filename);
+        strcat (name, JAMC_CACHE_SUFFIX);
+    }
+
+    return name;
+}
+
+/****************************************************************************/
+/*                                                                          */
+
+JAM_RETURN_TYPE urj_jam_load_statement_cache
+    (const char *filename, int64_t mtime)
+/*                                                                          */
+/*  Description:    Fills the cache from the cache file of the STAPL file   */
+/*                  filename, if it was written for this version of it.     */
+/*                                                                          */
+/*  Returns:        JAMC_SUCCESS if the cache file was loaded, else         */
+/*                  JAMC_IO_ERROR; the cache is empty in that case          */
+/*                                                                          */
+/****************************************************************************/
+{
+    JAM_RETURN_TYPE status = JAMC_IO_ERROR;
+    char header[sizeof JAMC_CACHE_HEADER];
+    char *name = urj_jam_cache_file_name (filename);
+    FILE *fp = NULL;
+    int64_t file_mtime = 0;
+    int32_t size = 0L;
+    int32_t count = 0L;
+    int32_t index = 0L;
+
+    if ((name == NULL) || (urj_jam_statement_cache == NULL))
+    {
+        free (name);
+        return JAMC_IO_ERROR;
+    }
+
+    fp = fopen (name, FOPEN_R);
+
+    if ((fp != NULL) &&
+        (fread (header, 1, sizeof header - 1, fp) == sizeof header - 1) &&
+        (memcmp (header, JAMC_CACHE_HEADER, sizeof header - 1) == 0) &&
+        (fread (&file_mtime, sizeof file_mtime, 1, fp) == 1) &&
+        (fread (&size, sizeof size, 1, fp) == 1) &&
+        (fread (&count, sizeof count, 1, fp) == 1) &&
+        (file_mtime == mtime) && (size == urj_jam_cache_program_size))
+    {
+        status = JAMC_SUCCESS;
+
+        for (index = 0; (status == JAMC_SUCCESS) && (index < count); ++index)
+        {
+            JAMS_STATEMENT_RECORD *record = NULL;
+            int32_t fields[6];
+
+            if ((fread (fields, sizeof fields[0], 6, fp) != 6) ||
+                (fields[4] < 0) || (fields[4] > JAMC_MAX_NAME_LENGTH) ||
+                (fields[5] < 0) || (fields[5] > JAMC_MAX_STATEMENT_LENGTH) ||
+                (fields[1] <= fields[0]) || (fields[1] >= size))
+            {
+                status = JAMC_IO_ERROR;
+            }
+            else if ((record = urj_jam_new_statement_record
+                      (fields[4], fields[5])) == NULL)
+            {
+                status = JAMC_OUT_OF_MEMORY;
+            }
+            else if ((fread (record->label, 1, fields[4], fp) !=
+                      (size_t) fields[4]) ||
+                     (fread (record->text, 1, fields[5], fp) !=
+                      (size_t) fields[5]))
+            {
+                free (record);
+                status = JAMC_IO_ERROR;
+            }
+            else
+            {
+                record->start = fields[0];
+                record->end = fields[1];
+                record->statement = fields[2];
+                record->next = fields[3];
+                urj_jam_insert_statement_record (record);
+            }
+        }
+    }
+
+    if (fp != NULL)
+    {
+        fclose (fp);
+    }
+
+    if (status != JAMC_SUCCESS)
+    {
+        /* don't run with a partially loaded cache */
+        int32_t program_size = urj_jam_cache_program_size;
+
+        urj_jam_init_statement_cache (program_size);
+        status = JAMC_IO_ERROR;
+    }
+    else
+    {
+        urj_log (URJ_LOG_LEVEL_DETAIL,
+                 "Loaded %d statements from \"%s\"\n", count, name);
+    }
+
+    free (name);
+
+    return status;
+}
+
+/****************************************************************************/
+/*                                                                          */
+
+JAM_RETURN_TYPE urj_jam_save_statement_cache
+    (const char *filename, int64_t mtime)
+/*                                                                          */
+/*  Description:    Writes the cache file of the STAPL file filename.  A    */
+/*                  file which cannot be written is not an error, the next  */
+/*                  run just compiles the program again.                    */
+/*                                                                          */
+/*  Returns:        JAMC_SUCCESS if the cache file was written, else        */
+/*                  JAMC_IO_ERROR                                           */
+/*                                                                          */
+/****************************************************************************/
+{
+    JAM_RETURN_TYPE status = JAMC_SUCCESS;
+    char *name = urj_jam_cache_file_name (filename);
+    FILE *fp = NULL;
+    int32_t index = 0L;
+
+    if ((name == NULL) || (urj_jam_statement_cache == NULL) ||
+        ((fp = fopen (name, FOPEN_W)) == NULL))
+    {
+        free (name);
+        return JAMC_IO_ERROR;
+    }
+
+    if ((fwrite (JAMC_CACHE_HEADER, 1, sizeof JAMC_CACHE_HEADER - 1, fp) !=
+         sizeof JAMC_CACHE_HEADER - 1) ||
+        (fwrite (&mtime, sizeof mtime, 1, fp) != 1) ||
+        (fwrite (&urj_jam_cache_program_size,
+                 sizeof urj_jam_cache_program_size, 1, fp) != 1) ||
+        (fwrite (&urj_jam_statement_count,
+                 sizeof urj_jam_statement_count, 1, fp) != 1))
+    {
+        status = JAMC_IO_ERROR;
+    }
+
+    for (index = 0; (status == JAMC_SUCCESS) &&
+         (index < urj_jam_statement_buckets); ++index)
+    {
+        JAMS_STATEMENT_RECORD *record = NULL;
+
+        for (record = urj_jam_statement_cache[index];
+             (status == JAMC_SUCCESS) && (record != NULL);
+             record = record->next_record)
+        {
+            int32_t fields[6];
+
+            fields[0] = record->start;
+            fields[1] = record->end;
+            fields[2] = record->statement;
+            fields[3] = record->next;
+            fields[4] = record->label_length;
+            fields[5] = record->text_length;
+
+            if ((fwrite (fields, sizeof fields[0], 6, fp) != 6) ||
+                (fwrite (record->label, 1, record->label_length, fp) !=
+                 (size_t) record->label_length) ||
+                (fwrite (record->text, 1, record->text_length, fp) !=
+                 (size_t) record->text_length))
+            {
+                status = JAMC_IO_ERROR;
+            }
+        }
+    }
+
+    if (fclose (fp) != 0)
+    {
+        status = JAMC_IO_ERROR;
+    }
+
+    if (status != JAMC_SUCCESS)
+    {
+        /* never leave a truncated cache file behind */
+        remove (name);
+    }
+
+    free (name);
+
+    return status;
+}
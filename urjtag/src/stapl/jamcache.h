@@ -0,0 +1,38 @@
+/****************************************************************************/
+/*                                                                          */
+/*  Module:         jamcache.h                                              */
+/*                                                                          */
+/*  Description:    Prototypes for the precompiled statement cache          */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef INC_JAMCACHE_H
+#define INC_JAMCACHE_H
+
+#include <stdint.h>
+
+/****************************************************************************/
+/*                                                                          */
+/*  Function Prototypes                                                     */
+/*                                                                          */
+/****************************************************************************/
+
+JAM_RETURN_TYPE urj_jam_init_statement_cache (int32_t program_size);
+
+void urj_jam_free_statement_cache (void);
+
+BOOL urj_jam_lookup_statement
+    (int32_t start, char *statement_buffer, char *label_buffer);
+
+void urj_jam_add_statement
+    (int32_t start, const char *statement_buffer, const char *label_buffer);
+
+JAM_RETURN_TYPE urj_jam_compile_statements (void);
+
+JAM_RETURN_TYPE urj_jam_load_statement_cache
+    (const char *filename, int64_t mtime);
+
+JAM_RETURN_TYPE urj_jam_save_statement_cache
+    (const char *filename, int64_t mtime);
+
+#endif /* INC_JAMCACHE_H */
@@ -30,6 +30,7 @@
 #include "jamarray.h"
 #include "jamjtag.h"
 #include "jamcomp.h"
+#include "jamcache.h"
 
 /****************************************************************************/
 /*                                                                          */
@@ -90,6 +91,7 @@ JAMS_SYMBOL_RECORD *urj_jam_current_block = NULL;
 BOOL urj_jam_checking_uses_list = false;
 
 /* function prototypes for forward reference */
+static int urj_jam_read_statement (char *statement_buffer, char *label_buffer);
 int urj_jam_get_statement (char *statement_buffer, char *label_buffer);
 JAME_INSTRUCTION urj_jam_get_instruction (char *statement);
 int urj_jam_skip_instruction_name (const char *statement_buffer);
@@ -187,8 +189,8 @@ int urj_jam_execute (char *program, int32_t program_size, char *workspace,
 /****************************************************************************/
 /*                                                                          */
 
-JAM_RETURN_TYPE
-urj_jam_get_statement (char *statement_buffer, char *label_buffer)
+static JAM_RETURN_TYPE
+urj_jam_read_statement (char *statement_buffer, char *label_buffer)
 /*                                                                          */
 /*  Description:    This function reads a full statement from the input     */
 /*                  stream, preprocesses it to remove comments, and stores  */
@@ -387,6 +389,36 @@ urj_jam_get_statement (char *statement_buffer, char *label_buffer)
     return status;
 }
 
+/****************************************************************************/
+/*                                                                          */
+
+JAM_RETURN_TYPE
+urj_jam_get_statement (char *statement_buffer, char *label_buffer)
+/*                                                                          */
+/*  Description:    Gets the statement at the current file position from    */
+/*                  the statement cache, or reads it from the input stream  */
+/*                  and adds it to the cache.                               */
+/*                                                                          */
+/*  Returns:        JAMC_SUCCESS for success, else appropriate error code   */
+/*                                                                          */
+/****************************************************************************/
+{
+    int32_t start = urj_jam_current_file_position;
+    JAM_RETURN_TYPE status = JAMC_SUCCESS;
+
+    if (!urj_jam_lookup_statement (start, statement_buffer, label_buffer))
+    {
+        status = urj_jam_read_statement (statement_buffer, label_buffer);
+
+        if (status == JAMC_SUCCESS)
+        {
+            urj_jam_add_statement (start, statement_buffer, label_buffer);
+        }
+    }
+
+    return status;
+}
+
 struct JAMS_INSTR_MAP
 {
     JAME_INSTRUCTION instruction;
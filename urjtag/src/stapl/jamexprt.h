@@ -91,6 +91,8 @@ int urj_jam_seek (int32_t offset);
 
 int urj_jam_jtag_io (int tms, int tdi, int read_tdo);
 
+void urj_jam_jtag_clock (int tms, int tdi, int32_t count);
+
 void urj_jam_message (const char *message_text);
 
 void urj_jam_export_integer (const char *key, int32_t value);
@@ -593,15 +593,10 @@ urj_jam_jtag_reset_idle (void)
 /*                                                                          */
 /****************************************************************************/
 {
-    int i = 0;
-
     /*
      *      Go to Test Logic Reset (no matter what the starting state may be)
      */
-    for (i = 0; i < 5; ++i)
-    {
-        urj_jam_jtag_io (TMS_HIGH, TDI_LOW, IGNORE_TDO);
-    }
+    urj_jam_jtag_clock (TMS_HIGH, TDI_LOW, 5);
 
     /*
      *      Now step to Run Test / Idle
@@ -727,7 +722,6 @@ JAM_RETURN_TYPE urj_jam_do_wait_cycles
 /****************************************************************************/
 {
     int tms = 0;
-    int32_t count = 0L;
     JAM_RETURN_TYPE status = JAMC_SUCCESS;
 
     if (urj_jam_jtag_state != wait_state)
@@ -743,10 +737,7 @@ JAM_RETURN_TYPE urj_jam_do_wait_cycles
          */
         tms = (wait_state == RESET) ? TMS_HIGH : TMS_LOW;
 
-        for (count = 0L; count < cycles; count++)
-        {
-            urj_jam_jtag_io (tms, TDI_LOW, IGNORE_TDO);
-        }
+        urj_jam_jtag_clock (tms, TDI_LOW, cycles);
     }
 
     return status;
@@ -28,6 +28,8 @@
 #include <time.h>
 
 #include "jamexprt.h"
+#include "jamdefs.h"
+#include "jamcache.h"
 #include "jamutil.h"
 #include <urjtag/chain.h>
 #include <urjtag/cable.h>
@@ -44,9 +46,15 @@ static char *file_buffer = NULL;
 static int32_t file_pointer = 0L;
 static int32_t file_length = 0L;
 
+/* one char per bit scan buffers, reused by all scans of a run */
+static char *scan_in = NULL;
+static char *scan_out = NULL;
+static int scan_length = 0;
+
 int urj_jam_getc (void);
 int urj_jam_seek (int32_t offset);
 int urj_jam_jtag_io (int tms, int tdi, int read_tdo);
+void urj_jam_jtag_clock (int tms, int tdi, int32_t count);
 int urj_jam_jtag_io_transfer (int count, char *tdi, char *tdo);
 void urj_jam_message (const char *message_text);
 void urj_jam_export_integer (const char *key, int32_t value);
@@ -100,76 +108,79 @@ urj_jam_jtag_io (int tms, int tdi, int read_tdo)
     return tdo;
 }
 
+// Clock count cycles with constant TMS and TDI as one deferred item
+void
+urj_jam_jtag_clock (int tms, int tdi, int32_t count)
+{
+    if (count > 0)
+        urj_tap_chain_defer_clock (current_chain, tms ? 0x01 : 0,
+                                   tdi ? 0x01 : 0, count);
+}
+
 // Vector-based JTAG communication via UrJTAG
 int
 urj_jam_jtag_io_transfer (int count, char *tdi, char *tdo)
 {
-    int i = 0;
-    int status = 1;
-    char *temp_in;
-    char *temp_out;
+    int i, j;
 
-    // if no data are requested, only schedule tdo transmit
-    if (tdo == NULL)
+    if (count <= 0)
+        return 1;
+
+    if (count > scan_length)
     {
-        for (i = 0; i < count; i++)
-            urj_jam_jtag_io ((i == count - 1),
-                             tdi[i >> 3] & (1 << (i & 7)),
-                             (tdo != NULL));
+        char *in = realloc (scan_in, count);
+        char *out;
+
+        if (in == NULL)
+            return 0;
+        scan_in = in;
+        out = realloc (scan_out, count);
+        if (out == NULL)
+            return 0;
+        scan_out = out;
+        scan_length = count;
     }
-    else
-    {
-        temp_in = malloc (count);
-        temp_out = malloc (count);
-        if ((temp_in == NULL) || (temp_out == NULL))
-            status = 0;
 
-        if (status != 0)
-        {
-            // decode bytes into bits to use them in UrJTAG interface
-            for (i = 0; i < count; i++)
-            {
-                temp_in[i] = tdi[i >> 3] & (1 << (i & 7));
-            }
-
-            /* loop in the SHIFT-DR(IR) state, TMS set to 0 */
-            urj_tap_cable_defer_transfer (current_cable, count - 1,
-                                          temp_in, temp_out);
+    // decode bytes into bits to use them in UrJTAG interface
+    for (i = 0; i < count; i++)
+        scan_in[i] = (tdi[i >> 3] >> (i & 7)) & 1;
 
+    /* loop in the SHIFT-DR(IR) state, TMS set to 0; the scan is queued as
+       a whole, a scan with capture is collected right away */
+    if (count > 1)
+        urj_tap_cable_defer_transfer (current_cable, count - 1, scan_in,
+                                      tdo ? scan_out : NULL);
 
-            // get the last bit in register and change TMS to 1
-            urj_tap_cable_defer_get_tdo (current_cable);
-            urj_tap_chain_defer_clock (current_chain, 1, temp_in[count - 1],
-                                       1);
-
-            urj_tap_cable_flush (current_cable, URJ_TAP_CABLE_COMPLETELY);
+    if (tdo == NULL)
+    {
+        // shift the last bit and change TMS to 1
+        urj_tap_chain_defer_clock (current_chain, 1, scan_in[count - 1], 1);
+        return 1;
+    }
 
-            urj_tap_cable_transfer_late (current_cable, temp_out);
-            temp_out[count - 1] = urj_tap_cable_get_tdo_late (current_cable);
+    // get the last bit in register and change TMS to 1
+    urj_tap_cable_defer_get_tdo (current_cable);
+    urj_tap_chain_defer_clock (current_chain, 1, scan_in[count - 1], 1);
 
+    /* asking for the result flushes the queue up to this scan */
+    if (count > 1)
+        urj_tap_cable_transfer_late (current_cable, scan_out);
+    scan_out[count - 1] = urj_tap_cable_get_tdo_late (current_cable);
 
-            // code bits back into bytes for Jam STAPL Player
-            for (i = 0; i < count; i++)
-            {
-                if (temp_out[i])
-                {
-                    tdo[i >> 3] |= (1 << (i & 7));
-                }
-                else
-                {
-                    tdo[i >> 3] &= ~(unsigned int) (1 << (i & 7));
-                }
-            }
-            free (temp_in);
-            free (temp_out);
-        }
-        else
-        {
-            return status;
-        }
+    // code bits back into bytes for Jam STAPL Player
+    for (i = 0; i < count; i += 8)
+    {
+        int n = count - i < 8 ? count - i : 8;
+        unsigned int mask = (1 << n) - 1;
+        unsigned int byte = 0;
+
+        for (j = 0; j < n; j++)
+            if (scan_out[i + j])
+                byte |= 1 << j;
+        tdo[i >> 3] = (tdo[i >> 3] & ~mask) | byte;
     }
 
-    return status;
+    return 1;
 }
 
 void
@@ -525,6 +536,22 @@ urj_stapl_run (urj_chain_t *chain, char *STAPL_file_name, char *STAPL_action)
                          value);
             }
 
+            /*
+             *  Preprocess all statements once, or load them from the
+             *  cache file written by an earlier run
+             */
+            if ((urj_jam_init_statement_cache (file_length) == JAMC_SUCCESS)
+                && (urj_jam_load_statement_cache (filename, sbuf.st_mtime)
+                    != JAMC_SUCCESS)
+                && (urj_jam_compile_statements () == JAMC_SUCCESS))
+            {
+                if (urj_jam_save_statement_cache (filename, sbuf.st_mtime)
+                    != JAMC_SUCCESS)
+                    urj_log (URJ_LOG_LEVEL_DETAIL,
+                             "Cannot write statement cache for \"%s\"\n",
+                             filename);
+            }
+
             // Execute the JAM program
             time (&start_time);
 
@@ -592,6 +619,11 @@ urj_stapl_run (urj_chain_t *chain, char *STAPL_file_name, char *STAPL_action)
         free (workspace);
     if (file_buffer != NULL)
         free (file_buffer);
+    urj_jam_free_statement_cache ();
+    free (scan_in);
+    free (scan_out);
+    scan_in = scan_out = NULL;
+    scan_length = 0;
 
     urj_log (URJ_LOG_LEVEL_NORMAL, "STAPL execution finished \n");
 
@@ -42,6 +42,8 @@
 
 #include <urjtag/error.h>
 #include <urjtag/cable.h>
+#include <urjtag/chain.h>
+#include <urjtag/tap.h>
 #include <urjtag/part.h>
 #include <urjtag/tap_state.h>
 #include <urjtag/tap_register.h>
@@ -71,21 +73,60 @@
 int urj_svf_parse (urj_svf_parser_priv_t *priv_data, urj_chain_t *chain);
 
 
+/* TDO check of a pipelined SIR/SDR, evaluated once its data arrived */
+struct svf_pending
+{
+    struct svf_pending *next;
+    urj_tap_register_t *out;    /* captured TDO of the SVF part */
+    int exitmode;               /* exit mode the part was shifted with */
+    char *tdo_bit;
+    char *mask_bit;
+    YYLTYPE loc;
+    int has_loc;
+};
+
+
 /*
  * urj_svf_force_reset_state()
  *
  * Puts TAP controller into reset state by clocking 5 times with TMS = 1.
  */
 static void
-urj_svf_force_reset_state (urj_chain_t *chain)
+urj_svf_force_reset_state (urj_chain_t *chain, urj_svf_parser_priv_t *priv)
 {
-    urj_tap_chain_clock (chain, 1, 0, 5);
+    if (priv->bin)
+        urj_svf_bin_tms (priv->bin, 1, 5);
+    else
+        urj_tap_chain_clock (chain, 1, 0, 5);
     urj_tap_state_reset (chain);
 }
 
 
 /*
- * urj_svf_goto_state(state)
+ * urj_svf_clock(chain, priv, tms, n)
+ *
+ * Clocks n times with TMS = tms, or records the clocks when compiling.
+ */
+static void
+urj_svf_clock (urj_chain_t *chain, urj_svf_parser_priv_t *priv, int tms,
+               int n)
+{
+    int i;
+
+    if (priv->bin == NULL)
+    {
+        CHAIN_CLOCK (chain, tms, 0, n);
+        return;
+    }
+
+    urj_svf_bin_tms (priv->bin, tms, n);
+    for (i = 0; i < n; i++)
+        urj_tap_state_clock (chain, tms);
+}
+
+
+/*
+ * urj_svf_goto_state(chain, priv, state)
  *
  * Moves from any TAP state to the specified state.
  * The state traversal is done according to the SVF specification.
@@ -97,7 +138,8 @@ urj_svf_force_reset_state (urj_chain_t *chain)
  *   state : new TAP controller state
  */
 static void
-urj_svf_goto_state (urj_chain_t *chain, int new_state)
+urj_svf_goto_state (urj_chain_t *chain, urj_svf_parser_priv_t *priv,
+                    int new_state)
 {
     int current_state;
 
@@ -114,11 +156,11 @@ urj_svf_goto_state (urj_chain_t *chain, int new_state)
     switch (current_state)
     {
     case URJ_TAP_STATE_TEST_LOGIC_RESET:
-        CHAIN_CLOCK (chain, 0, 0, 1);
+        urj_svf_clock (chain, priv, 0, 1);
         break;
 
     case URJ_TAP_STATE_RUN_TEST_IDLE:
-        CHAIN_CLOCK (chain, 1, 0, 1);
+        urj_svf_clock (chain, priv, 1, 1);
         break;
 
     case URJ_TAP_STATE_SELECT_DR_SCAN:
@@ -129,95 +171,95 @@ urj_svf_goto_state (urj_chain_t *chain, int new_state)
             || (current_state & URJ_TAP_STATE_IR
                 && new_state & URJ_TAP_STATE_DR))
             /* progress in select-idle/reset loop */
-            CHAIN_CLOCK (chain, 1, 0, 1);
+            urj_svf_clock (chain, priv, 1, 1);
         else
             /* enter DR/IR branch */
-            CHAIN_CLOCK (chain, 0, 0, 1);
+            urj_svf_clock (chain, priv, 0, 1);
         break;
 
     case URJ_TAP_STATE_CAPTURE_DR:
         if (new_state == URJ_TAP_STATE_SHIFT_DR)
             /* enter URJ_TAP_STATE_SHIFT_DR state */
-            CHAIN_CLOCK (chain, 0, 0, 1);
+            urj_svf_clock (chain, priv, 0, 1);
         else
             /* bypass URJ_TAP_STATE_SHIFT_DR */
-            CHAIN_CLOCK (chain, 1, 0, 1);
+            urj_svf_clock (chain, priv, 1, 1);
         break;
 
     case URJ_TAP_STATE_CAPTURE_IR:
         if (new_state == URJ_TAP_STATE_SHIFT_IR)
             /* enter URJ_TAP_STATE_SHIFT_IR state */
-            CHAIN_CLOCK (chain, 0, 0, 1);
+            urj_svf_clock (chain, priv, 0, 1);
         else
             /* bypass URJ_TAP_STATE_SHIFT_IR */
-            CHAIN_CLOCK (chain, 1, 0, 1);
+            urj_svf_clock (chain, priv, 1, 1);
         break;
 
     case URJ_TAP_STATE_SHIFT_DR:
     case URJ_TAP_STATE_SHIFT_IR:
         /* progress to URJ_TAP_STATE_EXIT1_DR/IR */
-        CHAIN_CLOCK (chain, 1, 0, 1);
+        urj_svf_clock (chain, priv, 1, 1);
         break;
 
     case URJ_TAP_STATE_EXIT1_DR:
         if (new_state == URJ_TAP_STATE_PAUSE_DR)
             /* enter URJ_TAP_STATE_PAUSE_DR state */
-            CHAIN_CLOCK (chain, 0, 0, 1);
+            urj_svf_clock (chain, priv, 0, 1);
         else
             /* bypass URJ_TAP_STATE_PAUSE_DR */
-            CHAIN_CLOCK (chain, 1, 0, 1);
+            urj_svf_clock (chain, priv, 1, 1);
         break;
 
     case URJ_TAP_STATE_EXIT1_IR:
         if (new_state == URJ_TAP_STATE_PAUSE_IR)
             /* enter URJ_TAP_STATE_PAUSE_IR state */
-            CHAIN_CLOCK (chain, 0, 0, 1);
+            urj_svf_clock (chain, priv, 0, 1);
         else
             /* bypass URJ_TAP_STATE_PAUSE_IR */
-            CHAIN_CLOCK (chain, 1, 0, 1);
+            urj_svf_clock (chain, priv, 1, 1);
         break;
 
     case URJ_TAP_STATE_PAUSE_DR:
     case URJ_TAP_STATE_PAUSE_IR:
         /* progress to URJ_TAP_STATE_EXIT2_DR/IR */
-        CHAIN_CLOCK (chain, 1, 0, 1);
+        urj_svf_clock (chain, priv, 1, 1);
         break;
 
     case URJ_TAP_STATE_EXIT2_DR:
         if (new_state == URJ_TAP_STATE_SHIFT_DR)
             /* enter URJ_TAP_STATE_SHIFT_DR state */
-            CHAIN_CLOCK (chain, 0, 0, 1);
+            urj_svf_clock (chain, priv, 0, 1);
         else
             /* progress to URJ_TAP_STATE_UPDATE_DR */
-            CHAIN_CLOCK (chain, 1, 0, 1);
+            urj_svf_clock (chain, priv, 1, 1);
         break;
 
     case URJ_TAP_STATE_EXIT2_IR:
         if (new_state == URJ_TAP_STATE_SHIFT_IR)
             /* enter URJ_TAP_STATE_SHIFT_IR state */
-            CHAIN_CLOCK (chain, 0, 0, 1);
+            urj_svf_clock (chain, priv, 0, 1);
         else
             /* progress to URJ_TAP_STATE_UPDATE_IR */
-            CHAIN_CLOCK (chain, 1, 0, 1);
+            urj_svf_clock (chain, priv, 1, 1);
         break;
 
     case URJ_TAP_STATE_UPDATE_DR:
     case URJ_TAP_STATE_UPDATE_IR:
         if (new_state == URJ_TAP_STATE_RUN_TEST_IDLE)
             /* enter URJ_TAP_STATE_RUN_TEST_IDLE */
-            CHAIN_CLOCK (chain, 0, 0, 1);
+            urj_svf_clock (chain, priv, 0, 1);
         else
             /* progress to Select_DR/IR */
-            CHAIN_CLOCK (chain, 1, 0, 1);
+            urj_svf_clock (chain, priv, 1, 1);
         break;
 
     default:
-        urj_svf_force_reset_state (chain);
+        urj_svf_force_reset_state (chain, priv);
         break;
     }
 
     /* continue state changes */
-    urj_svf_goto_state (chain, new_state);
+    urj_svf_goto_state (chain, priv, new_state);
 }
 
 
@@ -426,13 +468,15 @@ urj_svf_copy_hex_to_register (char *hex_string, urj_tap_register_t *reg)
 
 
 /*
+ * urj_svf_compare_bits(tdo_bit, mask_bit, reg)
  * urj_svf_compare_tdo(tdo, mask, reg)
  *
  * Compares the captured device output in tap register reg with the expected
  * hex_string tdo (specified in SVF command SDR/SDI.
  *
  * Comparison honours the "care" bits in mask ('1') while matching the contents
- * of reg with tdo.
+ * of reg with tdo. urj_svf_compare_bits() takes tdo and mask already
+ * converted with urj_svf_build_bit_string().
  *
  * Parameter:
  *   tdo  : reference hex string
@@ -444,20 +488,12 @@ urj_svf_copy_hex_to_register (char *hex_string, urj_tap_register_t *reg)
  *   URJ_STATUS_FAIL : tdo and reg do not match or error occurred
  */
 static int
-urj_svf_compare_tdo (urj_svf_parser_priv_t *priv, char *tdo, char *mask,
-                     urj_tap_register_t *reg, YYLTYPE *loc)
+urj_svf_compare_bits (urj_svf_parser_priv_t *priv, const char *tdo_bit,
+                      const char *mask_bit, urj_tap_register_t *reg,
+                      YYLTYPE *loc)
 {
-    char *tdo_bit, *mask_bit;
     int pos, mismatch, result = URJ_STATUS_OK;
 
-    if (!(tdo_bit = urj_svf_build_bit_string (tdo, reg->len)))
-        return URJ_STATUS_FAIL;
-    if (!(mask_bit = urj_svf_build_bit_string (mask, reg->len)))
-    {
-        free (tdo_bit);
-        return URJ_STATUS_FAIL;
-    }
-
     /* retrieve string representation */
     urj_tap_register_get_string (reg);
 
@@ -487,6 +523,26 @@ urj_svf_compare_tdo (urj_svf_parser_priv_t *priv, char *tdo, char *mask,
             result = URJ_STATUS_FAIL;
     }
 
+    return result;
+}
+
+static int
+urj_svf_compare_tdo (urj_svf_parser_priv_t *priv, char *tdo, char *mask,
+                     urj_tap_register_t *reg, YYLTYPE *loc)
+{
+    char *tdo_bit, *mask_bit;
+    int result;
+
+    if (!(tdo_bit = urj_svf_build_bit_string (tdo, reg->len)))
+        return URJ_STATUS_FAIL;
+    if (!(mask_bit = urj_svf_build_bit_string (mask, reg->len)))
+    {
+        free (tdo_bit);
+        return URJ_STATUS_FAIL;
+    }
+
+    result = urj_svf_compare_bits (priv, tdo_bit, mask_bit, reg, loc);
+
     free (mask_bit);
     free (tdo_bit);
 
@@ -494,6 +550,147 @@ urj_svf_compare_tdo (urj_svf_parser_priv_t *priv, char *tdo, char *mask,
 }
 
 
+static void
+urj_svf_free_pending (struct svf_pending *p)
+{
+    urj_tap_register_free (p->out);
+    free (p->tdo_bit);
+    free (p->mask_bit);
+    free (p);
+}
+
+
+/*
+ * urj_svf_check_pending(chain, priv, keep)
+ *
+ * Collects the TDO data of queued SIR/SDR commands in the order they were
+ * shifted and compares them against the expected values, until only keep
+ * checks are left in the queue.
+ *
+ * Return value:
+ *   URJ_STATUS_OK   : all evaluated checks matched
+ *   URJ_STATUS_FAIL : at least one mismatch (with stop on mismatch)
+ */
+static int
+urj_svf_check_pending (urj_chain_t *chain, urj_svf_parser_priv_t *priv,
+                       int keep)
+{
+    int result = URJ_STATUS_OK;
+
+    while (priv->pending_num > keep)
+    {
+        struct svf_pending *p = priv->pending_head;
+
+        priv->pending_head = p->next;
+        if (priv->pending_head == NULL)
+            priv->pending_tail = NULL;
+        priv->pending_num--;
+
+        /* the register is only used for its length as input here */
+        urj_tap_shift_register_output (chain, p->out, p->out, p->exitmode);
+
+        if (urj_svf_compare_bits (priv, p->tdo_bit, p->mask_bit, p->out,
+                                  p->has_loc ? &p->loc : NULL)
+            != URJ_STATUS_OK)
+        {
+            priv->mismatch_occurred = 1;
+            result = URJ_STATUS_FAIL;
+        }
+
+        urj_svf_free_pending (p);
+    }
+
+    return result;
+}
+
+
+/*
+ * urj_svf_queue_sxr(chain, priv, ir_dr, params, loc)
+ *
+ * Defers the shift of the current SIR/SDR for all parts in the chain and
+ * queues the TDO check of the SVF part instead of waiting for its data.
+ * Parts other than the SVF part are shifted without capturing output.
+ *
+ * Return value:
+ *   URJ_STATUS_OK, URJ_STATUS_FAIL
+ */
+static int
+urj_svf_queue_sxr (urj_chain_t *chain, urj_svf_parser_priv_t *priv,
+                   enum generic_irdr_coding ir_dr, struct ths_params *params,
+                   YYLTYPE *loc)
+{
+    urj_parts_t *ps = chain->parts;
+    struct svf_pending *p;
+    int i, len;
+
+    len = ir_dr == generic_ir ? priv->ir->value->len : priv->dr->in->len;
+
+    if (!(p = calloc (1, sizeof (struct svf_pending))))
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "calloc(%zd,%zd) fails",
+                       (size_t) 1, sizeof (struct svf_pending));
+        return URJ_STATUS_FAIL;
+    }
+    if (!(p->out = urj_tap_register_alloc (len))
+        || !(p->tdo_bit = urj_svf_build_bit_string (params->tdo, len))
+        || !(p->mask_bit = urj_svf_build_bit_string (params->mask, len)))
+    {
+        urj_svf_free_pending (p);
+        return URJ_STATUS_FAIL;
+    }
+    if (loc != NULL)
+    {
+        p->loc = *loc;
+        p->has_loc = 1;
+    }
+
+    for (i = 0; i < ps->len; i++)
+    {
+        urj_part_instruction_t *insn = ps->parts[i]->active_instruction;
+        int exitmode = (i + 1) == ps->len ? URJ_CHAIN_EXITMODE_EXIT1
+                                          : URJ_CHAIN_EXITMODE_SHIFT;
+
+        urj_tap_defer_shift_register (chain,
+                ir_dr == generic_ir ? insn->value : insn->data_register->in,
+                ps->parts[i] == priv->part ? p->out : NULL, exitmode);
+        if (ps->parts[i] == priv->part)
+            p->exitmode = exitmode;
+    }
+
+    if (priv->pending_tail)
+        priv->pending_tail->next = p;
+    else
+        priv->pending_head = p;
+    priv->pending_tail = p;
+    priv->pending_num++;
+
+    /* let the cable decide when to send; data is read when it is needed */
+    urj_tap_cable_flush (chain->cable, URJ_TAP_CABLE_OPTIONALLY);
+
+    return URJ_STATUS_OK;
+}
+
+
+/* all parts need an active instruction (with data register for SDR) */
+static int
+urj_svf_can_queue (urj_chain_t *chain, enum generic_irdr_coding ir_dr)
+{
+    urj_parts_t *ps = chain->parts;
+    int i;
+
+    for (i = 0; i < ps->len; i++)
+    {
+        if (ps->parts[i]->active_instruction == NULL)
+            return 0;
+        if (ir_dr == generic_dr
+            && ps->parts[i]->active_instruction->data_register == NULL)
+            return 0;
+    }
+
+    return 1;
+}
+
+
 /*
  * urj_svf_remember_param(rem, new)
  *
@@ -588,7 +785,7 @@ urj_svf_endxr (urj_svf_parser_priv_t *priv, enum generic_irdr_coding ir_dr,
 
 
 /* ***************************************************************************
- * urj_svf_frequency(chain, freq)
+ * urj_svf_frequency(chain, priv, freq)
  *
  * Implements the FREQUENCY command.
  *
@@ -596,9 +793,13 @@ urj_svf_endxr (urj_svf_parser_priv_t *priv, enum generic_irdr_coding ir_dr,
  *   freq : frequency in HZ
  * ***************************************************************************/
 void
-urj_svf_frequency (urj_chain_t *chain, double freq)
+urj_svf_frequency (urj_chain_t *chain, urj_svf_parser_priv_t *priv,
+                   double freq)
 {
-    urj_tap_cable_set_frequency (chain->cable, freq);
+    if (priv->bin)
+        urj_svf_bin_frequency (priv->bin, freq);
+    else
+        urj_tap_cable_set_frequency (chain->cable, freq);
 }
 
 
@@ -689,6 +890,17 @@ urj_svf_runtest (urj_chain_t *chain, urj_svf_parser_priv_t *priv,
     if (params->end_state != 0)
         priv->runtest_end_state = urj_svf_map_state (params->end_state);
 
+    /* the run count depends on the frequency at playback time */
+    if (priv->bin)
+    {
+        urj_svf_goto_state (chain, priv, priv->runtest_run_state);
+        urj_svf_bin_runtest (priv->bin, params->run_count, params->min_time,
+                             params->max_time);
+        urj_svf_goto_state (chain, priv, priv->runtest_end_state);
+
+        return URJ_STATUS_OK;
+    }
+
     /* compute run_count */
     run_count = params->run_count;
     if (params->min_time > 0.0)
@@ -715,7 +927,7 @@ urj_svf_runtest (urj_chain_t *chain, urj_svf_parser_priv_t *priv,
         }
     }
 
-    urj_svf_goto_state (chain, priv->runtest_run_state);
+    urj_svf_goto_state (chain, priv, priv->runtest_run_state);
 
 #ifndef HAVE_SIGACTION_SA_ONESHOT
     if (params->max_time > 0.0)
@@ -730,7 +942,7 @@ urj_svf_runtest (urj_chain_t *chain, urj_svf_parser_priv_t *priv,
     else
         CHAIN_CLOCK (chain, 0, 0, run_count);
 
-    urj_svf_goto_state (chain, priv->runtest_end_state);
+    urj_svf_goto_state (chain, priv, priv->runtest_end_state);
 
 #else
     /* set up the timer for max_time */
@@ -764,7 +976,7 @@ urj_svf_runtest (urj_chain_t *chain, urj_svf_parser_priv_t *priv,
     else
         CHAIN_CLOCK (chain, 0, 0, run_count);
 
-    urj_svf_goto_state (chain, priv->runtest_end_state);
+    urj_svf_goto_state (chain, priv, priv->runtest_end_state);
 
     /* stop the timer */
     if (params->max_time > 0.0)
@@ -808,11 +1020,12 @@ urj_svf_state (urj_chain_t *chain, urj_svf_parser_priv_t *priv,
     priv->svf_state_executed = 1;
 
     for (i = 0; i < path_states->num_states; i++)
-        urj_svf_goto_state (chain,
+        urj_svf_goto_state (chain, priv,
                             urj_svf_map_state (path_states->states[i]));
 
     if (stable_state)
-        urj_svf_goto_state (chain, urj_svf_map_state (stable_state));
+        urj_svf_goto_state (chain, priv,
+                            urj_svf_map_state (stable_state));
 
     return URJ_STATUS_OK;
 }
@@ -944,15 +1157,72 @@ urj_svf_sxr (urj_chain_t *chain, urj_svf_parser_priv_t *priv,
         return URJ_STATUS_FAIL;
 
 
+    /* record the scan of the whole chain, see urj_svf_compile() */
+    if (priv->bin)
+    {
+        char *tdo_bit = NULL, *mask_bit = NULL;
+
+        if (!urj_svf_can_queue (chain, ir_dr))
+        {
+            urj_error_set (URJ_ERROR_INVALID,
+                           _("%s: all parts need an active instruction for compiling"),
+                           "svf");
+            return URJ_STATUS_FAIL;
+        }
+        if (sxr_params->params.tdo)
+        {
+            if (!(tdo_bit = urj_svf_build_bit_string (sxr_params->params.tdo,
+                                                      len))
+                || !(mask_bit =
+                     urj_svf_build_bit_string (sxr_params->params.mask, len)))
+            {
+                free (tdo_bit);
+                return URJ_STATUS_FAIL;
+            }
+        }
+
+        urj_svf_goto_state (chain, priv, ir_dr == generic_ir
+                                         ? URJ_TAP_STATE_SHIFT_IR
+                                         : URJ_TAP_STATE_SHIFT_DR);
+        result = urj_svf_bin_shift (priv->bin, chain, priv->part, ir_dr,
+                                    tdo_bit, mask_bit,
+                                    loc != NULL ? loc->first_line + 1 : 0);
+        /* the last bit leaves Shift-IR/DR */
+        urj_tap_state_clock (chain, 1);
+        urj_svf_goto_state (chain, priv, ir_dr == generic_ir ? priv->endir
+                                                             : priv->enddr);
+
+        free (mask_bit);
+        free (tdo_bit);
+
+        return result;
+    }
+
+    /* queue the TDO check and keep going, see urj_svf_run_pipelined() */
+    if (priv->pipeline_depth > 0 && sxr_params->params.tdo
+        && urj_svf_can_queue (chain, ir_dr))
+    {
+        urj_svf_goto_state (chain, priv, ir_dr == generic_ir
+                                         ? URJ_TAP_STATE_SHIFT_IR
+                                         : URJ_TAP_STATE_SHIFT_DR);
+        if (urj_svf_queue_sxr (chain, priv, ir_dr, &sxr_params->params, loc)
+            != URJ_STATUS_OK)
+            return URJ_STATUS_FAIL;
+        urj_svf_goto_state (chain, priv, ir_dr == generic_ir ? priv->endir
+                                                             : priv->enddr);
+
+        return urj_svf_check_pending (chain, priv, priv->pipeline_depth);
+    }
+
     /* shift selected instruction/register */
     switch (ir_dr)
     {
     case generic_ir:
-        urj_svf_goto_state (chain, URJ_TAP_STATE_SHIFT_IR);
+        urj_svf_goto_state (chain, priv, URJ_TAP_STATE_SHIFT_IR);
         urj_tap_chain_shift_instructions_mode (chain,
                                                sxr_params->params.tdo ? 1 : 0,
                                                0, URJ_CHAIN_EXITMODE_EXIT1);
-        urj_svf_goto_state (chain, priv->endir);
+        urj_svf_goto_state (chain, priv, priv->endir);
 
         if (sxr_params->params.tdo)
             result = urj_svf_compare_tdo (priv, sxr_params->params.tdo,
@@ -961,12 +1231,12 @@ urj_svf_sxr (urj_chain_t *chain, urj_svf_parser_priv_t *priv,
         break;
 
     case generic_dr:
-        urj_svf_goto_state (chain, URJ_TAP_STATE_SHIFT_DR);
+        urj_svf_goto_state (chain, priv, URJ_TAP_STATE_SHIFT_DR);
         urj_tap_chain_shift_data_registers_mode (chain,
                                                  sxr_params->params.
                                                  tdo ? 1 : 0, 0,
                                                  URJ_CHAIN_EXITMODE_EXIT1);
-        urj_svf_goto_state (chain, priv->enddr);
+        urj_svf_goto_state (chain, priv, priv->enddr);
 
         if (sxr_params->params.tdo)
             result = urj_svf_compare_tdo (priv, sxr_params->params.tdo,
@@ -1051,6 +1321,8 @@ urj_svf_trst (urj_chain_t *chain, urj_svf_parser_priv_t *priv, int trst_mode)
     if (trst_cable < 0)
         urj_warning (_("unimplemented mode '%s' for TRST\n"),
                      unimplemented_mode);
+    else if (priv->bin)
+        urj_svf_bin_trst (priv->bin, trst_cable);
     else
         urj_tap_cable_set_signal (chain->cable, URJ_POD_CS_TRST,
                                   trst_cable ? URJ_POD_CS_TRST : 0);
@@ -1085,28 +1357,15 @@ urj_svf_txr (enum generic_irdr_coding ir_dr, struct ths_params *params)
 }
 
 
-/* ***************************************************************************
- * urj_svf_run(chain, SVF_FILE, stop_on_mismatch, ref_freq)
- *
- * Main entry point for the 'svf' command. Calls the svf parser.
- *
- * Checks the jtag-environment (availability of SIR instruction and SDR
- * register). Initializes all svf-global variables and performs clean-up
- * afterwards.
- *
- * Parameter:
- *   chain            : pointer to global chain
- *   SVF_FILE         : file handle of SVF file
- *   stop_on_mismatch : 1 = stop upon tdo mismatch
- *                      0 = continue upon mismatch
- *   ref_freq         : reference frequency for RUNTEST
+/*
+ * urj_svf_execute(chain, SVF_FILE, stop_on_mismatch, ref_freq, depth, bin)
  *
- * Return value:
- *   URJ_STATUS_OK, URJ_STATUS_FAIL
- * ***************************************************************************/
-int
-urj_svf_run (urj_chain_t *chain, FILE *SVF_FILE, int stop_on_mismatch,
-             uint32_t ref_freq)
+ * Runs the parser on SVF_FILE, shifting the commands or recording them
+ * in bin when compiling.
+ */
+static int
+urj_svf_execute (urj_chain_t *chain, FILE *SVF_FILE, int stop_on_mismatch,
+                 uint32_t ref_freq, int depth, urj_svf_bin_t *bin)
 {
     const urj_svf_sxr_t sxr_default = { {0.0, NULL, NULL, NULL, NULL},
     1, 1
@@ -1114,12 +1373,11 @@ urj_svf_run (urj_chain_t *chain, FILE *SVF_FILE, int stop_on_mismatch,
     urj_svf_parser_priv_t priv;
     int c = ~EOF;
     int num_lines;
-    uint32_t old_frequency;
-
-    if (chain == NULL || chain->cable == NULL)
-        return  URJ_STATUS_FAIL;
+    uint32_t old_frequency = 0;
+    int result = URJ_STATUS_OK;
 
-    old_frequency = urj_tap_cable_get_frequency (chain->cable);
+    if (bin == NULL)
+        old_frequency = urj_tap_cable_get_frequency (chain->cable);
 
     /* get number of lines in svf file so we can give user some feedback on long
        files or slow cables */
@@ -1231,21 +1489,37 @@ urj_svf_run (urj_chain_t *chain, FILE *SVF_FILE, int stop_on_mismatch,
 
     priv.ref_freq = ref_freq;
 
+    priv.pipeline_depth = depth > 0 ? depth : 0;
+    priv.pending_num = 0;
+    priv.pending_head = priv.pending_tail = NULL;
+
+    priv.bin = bin;
+
     /* select SIR instruction */
     urj_part_set_instruction (priv.part, "SIR");
 
     if (urj_svf_bison_init (&priv, SVF_FILE, num_lines))
     {
-        urj_svf_parse (&priv, chain);
+        /* a partial compiled file would be played without complaint */
+        if (urj_svf_parse (&priv, chain) != 0 && bin != NULL)
+            result = URJ_STATUS_FAIL;
         urj_svf_bison_deinit (&priv);
     }
+    else if (bin != NULL)
+        result = URJ_STATUS_FAIL;
 
-    if (priv.mismatch_occurred > 0)
-        urj_log (URJ_LOG_LEVEL_DETAIL,
-                 _("Mismatches occurred between scanned device output and expected TDO values.\n"));
-    else
-        urj_log (URJ_LOG_LEVEL_DETAIL,
-                 _("Scanned device output matched expected TDO values.\n"));
+    /* evaluate the checks still in flight */
+    urj_svf_check_pending (chain, &priv, 0);
+
+    if (bin == NULL)
+    {
+        if (priv.mismatch_occurred > 0)
+            urj_log (URJ_LOG_LEVEL_DETAIL,
+                     _("Mismatches occurred between scanned device output and expected TDO values.\n"));
+        else
+            urj_log (URJ_LOG_LEVEL_DETAIL,
+                     _("Scanned device output matched expected TDO values.\n"));
+    }
 
     /* clean up */
     /* SIR */
@@ -1264,8 +1538,93 @@ urj_svf_run (urj_chain_t *chain, FILE *SVF_FILE, int stop_on_mismatch,
         free (priv.sdr_params.params.smask);
 
     /* restore previous frequency setting, required by SVF spec */
-    if (old_frequency != urj_tap_cable_get_frequency (chain->cable))
+    if (bin == NULL
+        && old_frequency != urj_tap_cable_get_frequency (chain->cable))
         urj_tap_cable_set_frequency (chain->cable, old_frequency);
 
-    return URJ_STATUS_OK;
+    return result;
+}
+
+
+/* ***************************************************************************
+ * urj_svf_run(chain, SVF_FILE, stop_on_mismatch, ref_freq)
+ *
+ * Main entry point for the 'svf' command. Calls the svf parser.
+ *
+ * Checks the jtag-environment (availability of SIR instruction and SDR
+ * register). Initializes all svf-global variables and performs clean-up
+ * afterwards.
+ *
+ * Parameter:
+ *   chain            : pointer to global chain
+ *   SVF_FILE         : file handle of SVF file
+ *   stop_on_mismatch : 1 = stop upon tdo mismatch
+ *                      0 = continue upon mismatch
+ *   ref_freq         : reference frequency for RUNTEST
+ *
+ * Return value:
+ *   URJ_STATUS_OK, URJ_STATUS_FAIL
+ * ***************************************************************************/
+int
+urj_svf_run (urj_chain_t *chain, FILE *SVF_FILE, int stop_on_mismatch,
+             uint32_t ref_freq)
+{
+    return urj_svf_run_pipelined (chain, SVF_FILE, stop_on_mismatch,
+                                  ref_freq, 0);
+}
+
+
+/* ***************************************************************************
+ * urj_svf_run_pipelined(chain, SVF_FILE, stop_on_mismatch, ref_freq, depth)
+ *
+ * Like urj_svf_run(), keeps up to depth TDO checks of SIR/SDR commands
+ * outstanding while shifting the next commands.
+ * ***************************************************************************/
+int
+urj_svf_run_pipelined (urj_chain_t *chain, FILE *SVF_FILE,
+                       int stop_on_mismatch, uint32_t ref_freq, int depth)
+{
+    if (chain == NULL || chain->cable == NULL)
+        return  URJ_STATUS_FAIL;
+
+    return urj_svf_execute (chain, SVF_FILE, stop_on_mismatch, ref_freq,
+                            depth, NULL);
+}
+
+
+/* ***************************************************************************
+ * urj_svf_compile(chain, SVF_FILE, out)
+ *
+ * Translates SVF_FILE into a compiled command stream for the current
+ * chain, see urj_svf_play(). Nothing is shifted and the TAP state of the
+ * chain is left unchanged.
+ * ***************************************************************************/
+int
+urj_svf_compile (urj_chain_t *chain, FILE *SVF_FILE, FILE *out)
+{
+    urj_svf_bin_t *bin;
+    int old_state, result;
+
+    if (chain == NULL || chain->parts == NULL)
+    {
+        urj_error_set (URJ_ERROR_NO_CHAIN, _("%s: no JTAG chain available"),
+                       "svf");
+        return URJ_STATUS_FAIL;
+    }
+
+    if (!(bin = urj_svf_bin_open (chain, out)))
+        return URJ_STATUS_FAIL;
+
+    /* start from an unknown state, the stream begins with a reset */
+    old_state = urj_tap_state (chain);
+    urj_tap_state_init (chain);
+
+    result = urj_svf_execute (chain, SVF_FILE, 1, 0, 0, bin);
+
+    chain->state = old_state;
+
+    if (urj_svf_bin_close (bin) != URJ_STATUS_OK)
+        result = URJ_STATUS_FAIL;
+
+    return result;
 }
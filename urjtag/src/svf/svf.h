@@ -119,6 +119,13 @@ struct parser_priv
     int mismatch_occurred;
     /* protocol issued warnings */
     int issued_runtest_maxtime;
+    /* queued TDO checks of pipelined SIR/SDR commands */
+    int pipeline_depth;
+    int pending_num;
+    struct svf_pending *pending_head;
+    struct svf_pending *pending_tail;
+    /* output of 'svf compile', NULL when executing on the chain */
+    struct svf_bin *bin;
 };
 typedef struct parser_priv urj_svf_parser_priv_t;
 
@@ -140,7 +147,7 @@ void urj_svf_bison_deinit (urj_svf_parser_priv_t *);
 
 void urj_svf_endxr (urj_svf_parser_priv_t *, enum generic_irdr_coding,
                     int);
-void urj_svf_frequency (urj_chain_t *, double);
+void urj_svf_frequency (urj_chain_t *, urj_svf_parser_priv_t *, double);
 int urj_svf_hxr (enum generic_irdr_coding, struct ths_params *);
 int urj_svf_runtest (urj_chain_t *, urj_svf_parser_priv_t *,
                      struct runtest *);
@@ -151,3 +158,52 @@ int urj_svf_sxr (urj_chain_t *, urj_svf_parser_priv_t *,
                  struct YYLTYPE *);
 int urj_svf_trst (urj_chain_t *, urj_svf_parser_priv_t *, int);
 int urj_svf_txr (enum generic_irdr_coding, struct ths_params *);
+
+
+/*
+ * Compiled SVF files
+ *
+ * A compiled file starts with URJ_SVF_BIN_MAGIC and a signature of the
+ * chain it was compiled for: the number of parts followed by the
+ * instruction length of each part. Records follow, each starting with an
+ * opcode byte. All numbers are little endian, bit vectors are packed LSB
+ * first (bit i in byte i / 8, bit i % 8).
+ *
+ *   TMS     : u32 n, n packed TMS bits (TDI = 0)
+ *   SHIFT   : u8 flags, u32 len, u32 line, u32 part_off, u32 part_len,
+ *             len packed TDI bits for the whole chain;
+ *             with URJ_SVF_BIN_SHIFT_TDO part_len packed TDO and MASK bits
+ *             of the SVF part, which starts at bit part_off.
+ *             Starts in Shift-IR/DR, the last bit is clocked with TMS = 1.
+ *   RUNTEST : u32 run_count, u64 min_time, u64 max_time (in ns)
+ *   FREQ    : u32 frequency in Hz, 0 = full speed
+ *   TRST    : u8 value of the TRST signal
+ *   END
+ */
+#define URJ_SVF_BIN_MAGIC       "URJSVFB1"
+#define URJ_SVF_BIN_MAGIC_LEN   8
+
+enum urj_svf_bin_op
+{
+    URJ_SVF_BIN_END = 0,
+    URJ_SVF_BIN_TMS,
+    URJ_SVF_BIN_SHIFT,
+    URJ_SVF_BIN_RUNTEST,
+    URJ_SVF_BIN_FREQ,
+    URJ_SVF_BIN_TRST,
+};
+
+#define URJ_SVF_BIN_SHIFT_IR    0x01
+#define URJ_SVF_BIN_SHIFT_TDO   0x02
+
+typedef struct svf_bin urj_svf_bin_t;
+
+urj_svf_bin_t *urj_svf_bin_open (urj_chain_t *, FILE *);
+int urj_svf_bin_close (urj_svf_bin_t *);
+int urj_svf_bin_tms (urj_svf_bin_t *, int, int);
+int urj_svf_bin_shift (urj_svf_bin_t *, urj_chain_t *, urj_part_t *,
+                       enum generic_irdr_coding, const char *, const char *,
+                       int);
+int urj_svf_bin_runtest (urj_svf_bin_t *, uint32_t, double, double);
+int urj_svf_bin_frequency (urj_svf_bin_t *, uint32_t);
+int urj_svf_bin_trst (urj_svf_bin_t *, int);
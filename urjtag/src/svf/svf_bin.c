@@ -0,0 +1,851 @@
+/*
+ * $Id$
+ *
+ * Compiled SVF command streams
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ * 02111-1307, USA.
+ *
+ * 'svf compile' resolves everything the SVF player computes for each
+ * command (state paths, hex strings, the scan of the whole chain) once and
+ * stores the result as a stream of records, see svf.h. Playback maps the
+ * file and feeds the records to the cable queue without parsing.
+ *
+ */
+
+#include <sysdep.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <math.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+
+#include <urjtag/error.h>
+#include <urjtag/log.h>
+#include <urjtag/cable.h>
+#include <urjtag/chain.h>
+#include <urjtag/tap.h>
+#include <urjtag/part.h>
+#include <urjtag/tap_state.h>
+#include <urjtag/tap_register.h>
+#include <urjtag/part_instruction.h>
+#include <urjtag/data_register.h>
+#include <urjtag/svf.h>
+#include <urjtag/fclock.h>
+
+#include "svf.h"
+
+#define BIN_BYTES(bits)         (((bits) + 7) / 8)
+#define BIN_GET_BIT(p, i)       (((p)[(i) / 8] >> ((i) % 8)) & 1)
+
+struct svf_bin
+{
+    FILE *f;
+    int error;
+    /* TMS bits not written yet, packed */
+    unsigned char *tms;
+    uint32_t tms_len;
+    size_t tms_max;
+};
+
+/* TDO check of a played SHIFT record */
+struct svf_bin_pending
+{
+    struct svf_bin_pending *next;
+    char *out;
+    uint32_t len;
+    uint32_t line;
+    uint32_t part_off;
+    urj_tap_packed_t *tdo;
+    urj_tap_packed_t *mask;
+    urj_tap_packed_t *got;      /* captured TDO of the SVF part */
+};
+
+
+static void
+bin_write (urj_svf_bin_t *bin, const void *data, size_t len)
+{
+    if (bin->error)
+        return;
+
+    if (fwrite (data, 1, len, bin->f) != len)
+    {
+        urj_error_IO_set (_("%s: cannot write compiled file"), "svf");
+        bin->error = 1;
+    }
+}
+
+static void
+bin_write_u8 (urj_svf_bin_t *bin, int v)
+{
+    unsigned char b = v;
+
+    bin_write (bin, &b, 1);
+}
+
+static void
+bin_write_u32 (urj_svf_bin_t *bin, uint32_t v)
+{
+    unsigned char b[4];
+
+    b[0] = v;
+    b[1] = v >> 8;
+    b[2] = v >> 16;
+    b[3] = v >> 24;
+    bin_write (bin, b, sizeof b);
+}
+
+static void
+bin_write_u64 (urj_svf_bin_t *bin, uint64_t v)
+{
+    bin_write_u32 (bin, v);
+    bin_write_u32 (bin, v >> 32);
+}
+
+/* vectors are stored LSB first, bit n in byte n / 8 */
+static void
+bin_write_packed (urj_svf_bin_t *bin, const urj_tap_packed_t *tp)
+{
+    unsigned char b[8];
+    int i, k, n = BIN_BYTES (tp->len);
+
+    for (i = 0; i < n; i += 8)
+    {
+        uint64_t w = tp->data[i / 8];
+
+        for (k = 0; k < 8; k++, w >>= 8)
+            b[k] = w;
+        bin_write (bin, b, n - i < 8 ? n - i : 8);
+    }
+}
+
+static void
+bin_flush_tms (urj_svf_bin_t *bin)
+{
+    if (bin->tms_len == 0)
+        return;
+
+    bin_write_u8 (bin, URJ_SVF_BIN_TMS);
+    bin_write_u32 (bin, bin->tms_len);
+    bin_write (bin, bin->tms, BIN_BYTES (bin->tms_len));
+    bin->tms_len = 0;
+}
+
+
+urj_svf_bin_t *
+urj_svf_bin_open (urj_chain_t *chain, FILE *f)
+{
+    urj_svf_bin_t *bin;
+    int i;
+
+    if (!(bin = calloc (1, sizeof (urj_svf_bin_t))))
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "calloc(%zd,%zd) fails",
+                       (size_t) 1, sizeof (urj_svf_bin_t));
+        return NULL;
+    }
+    bin->f = f;
+
+    bin_write (bin, URJ_SVF_BIN_MAGIC, URJ_SVF_BIN_MAGIC_LEN);
+    bin_write_u32 (bin, chain->parts->len);
+    for (i = 0; i < chain->parts->len; i++)
+        bin_write_u32 (bin, chain->parts->parts[i]->instruction_length);
+
+    return bin;
+}
+
+int
+urj_svf_bin_close (urj_svf_bin_t *bin)
+{
+    int result;
+
+    bin_flush_tms (bin);
+    bin_write_u8 (bin, URJ_SVF_BIN_END);
+    if (!bin->error && fflush (bin->f) != 0)
+    {
+        urj_error_IO_set (_("%s: cannot write compiled file"), "svf");
+        bin->error = 1;
+    }
+
+    result = bin->error ? URJ_STATUS_FAIL : URJ_STATUS_OK;
+
+    free (bin->tms);
+    free (bin);
+
+    return result;
+}
+
+int
+urj_svf_bin_tms (urj_svf_bin_t *bin, int tms, int n)
+{
+    for (; n > 0; n--)
+    {
+        if (BIN_BYTES (bin->tms_len + 1) > bin->tms_max)
+        {
+            size_t max = bin->tms_max ? bin->tms_max * 2 : 64;
+            unsigned char *p = realloc (bin->tms, max);
+
+            if (p == NULL)
+            {
+                urj_error_set (URJ_ERROR_OUT_OF_MEMORY,
+                               "realloc(%s,%zd) fails", "bin->tms", max);
+                bin->error = 1;
+                return URJ_STATUS_FAIL;
+            }
+            bin->tms = p;
+            bin->tms_max = max;
+        }
+
+        if (bin->tms_len % 8 == 0)
+            bin->tms[bin->tms_len / 8] = 0;
+        if (tms)
+            bin->tms[bin->tms_len / 8] |= 1 << (bin->tms_len % 8);
+        bin->tms_len++;
+    }
+
+    return URJ_STATUS_OK;
+}
+
+/*
+ * urj_svf_bin_shift(bin, chain, part, ir_dr, tdo_bit, mask_bit, line)
+ *
+ * Records the scan of the active instructions (SIR) or their data
+ * registers (SDR) of all parts. tdo_bit and mask_bit are bit strings
+ * of the SVF part as built by the SVF player, or NULL without TDO.
+ */
+int
+urj_svf_bin_shift (urj_svf_bin_t *bin, urj_chain_t *chain, urj_part_t *part,
+                   enum generic_irdr_coding ir_dr, const char *tdo_bit,
+                   const char *mask_bit, int line)
+{
+    urj_parts_t *ps = chain->parts;
+    urj_tap_packed_t *vec;
+    uint32_t len = 0, part_off = 0, part_len = 0, pos;
+    int i, j;
+
+    for (i = 0; i < ps->len; i++)
+    {
+        urj_part_instruction_t *insn = ps->parts[i]->active_instruction;
+        urj_tap_register_t *r = ir_dr == generic_ir ? insn->value
+                                                    : insn->data_register->in;
+
+        if (ps->parts[i] == part)
+        {
+            part_off = len;
+            part_len = r->len;
+        }
+        len += r->len;
+    }
+
+    bin_flush_tms (bin);
+    bin_write_u8 (bin, URJ_SVF_BIN_SHIFT);
+    bin_write_u8 (bin, (ir_dr == generic_ir ? URJ_SVF_BIN_SHIFT_IR : 0)
+                       | (tdo_bit ? URJ_SVF_BIN_SHIFT_TDO : 0));
+    bin_write_u32 (bin, len);
+    bin_write_u32 (bin, line);
+    bin_write_u32 (bin, part_off);
+    bin_write_u32 (bin, part_len);
+
+    if (!(vec = urj_tap_packed_alloc (len)))
+    {
+        bin->error = 1;
+        return URJ_STATUS_FAIL;
+    }
+    for (i = 0, pos = 0; i < ps->len; i++)
+    {
+        urj_part_instruction_t *insn = ps->parts[i]->active_instruction;
+        urj_tap_register_t *r = ir_dr == generic_ir ? insn->value
+                                                    : insn->data_register->in;
+
+        for (j = 0; j < r->len; j++, pos++)
+            if (r->data[j])
+                urj_tap_packed_set_bit (vec, pos, 1);
+    }
+    bin_write_packed (bin, vec);
+    urj_tap_packed_free (vec);
+
+    if (tdo_bit)
+    {
+        if (!(vec = urj_tap_packed_alloc (part_len)))
+        {
+            bin->error = 1;
+            return URJ_STATUS_FAIL;
+        }
+
+        /* bit strings are MSB first */
+        for (pos = 0; pos < part_len; pos++)
+            urj_tap_packed_set_bit (vec, pos,
+                                    tdo_bit[part_len - 1 - pos] == '1');
+        bin_write_packed (bin, vec);
+
+        for (pos = 0; pos < part_len; pos++)
+            urj_tap_packed_set_bit (vec, pos,
+                                    mask_bit[part_len - 1 - pos] == '1');
+        bin_write_packed (bin, vec);
+        urj_tap_packed_free (vec);
+    }
+
+    return bin->error ? URJ_STATUS_FAIL : URJ_STATUS_OK;
+}
+
+int
+urj_svf_bin_runtest (urj_svf_bin_t *bin, uint32_t run_count,
+                     double min_time, double max_time)
+{
+    bin_flush_tms (bin);
+    bin_write_u8 (bin, URJ_SVF_BIN_RUNTEST);
+    bin_write_u32 (bin, run_count);
+    bin_write_u64 (bin, min_time > 0.0 ? ceil (min_time * 1e9) : 0);
+    bin_write_u64 (bin, max_time > 0.0 ? ceil (max_time * 1e9) : 0);
+
+    return bin->error ? URJ_STATUS_FAIL : URJ_STATUS_OK;
+}
+
+int
+urj_svf_bin_frequency (urj_svf_bin_t *bin, uint32_t freq)
+{
+    bin_flush_tms (bin);
+    bin_write_u8 (bin, URJ_SVF_BIN_FREQ);
+    bin_write_u32 (bin, freq);
+
+    return bin->error ? URJ_STATUS_FAIL : URJ_STATUS_OK;
+}
+
+int
+urj_svf_bin_trst (urj_svf_bin_t *bin, int value)
+{
+    bin_flush_tms (bin);
+    bin_write_u8 (bin, URJ_SVF_BIN_TRST);
+    bin_write_u8 (bin, value ? 1 : 0);
+
+    return bin->error ? URJ_STATUS_FAIL : URJ_STATUS_OK;
+}
+
+
+/* playback */
+
+struct svf_bin_reader
+{
+    const unsigned char *pos;
+    const unsigned char *end;
+};
+
+static const unsigned char *
+bin_read (struct svf_bin_reader *r, size_t len)
+{
+    const unsigned char *p = r->pos;
+
+    if ((size_t) (r->end - r->pos) < len)
+        return NULL;
+    r->pos += len;
+
+    return p;
+}
+
+static int
+bin_read_u8 (struct svf_bin_reader *r, uint32_t *v)
+{
+    const unsigned char *p = bin_read (r, 1);
+
+    if (p == NULL)
+        return URJ_STATUS_FAIL;
+    *v = p[0];
+
+    return URJ_STATUS_OK;
+}
+
+static int
+bin_read_u32 (struct svf_bin_reader *r, uint32_t *v)
+{
+    const unsigned char *p = bin_read (r, 4);
+
+    if (p == NULL)
+        return URJ_STATUS_FAIL;
+    *v = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24);
+
+    return URJ_STATUS_OK;
+}
+
+static int
+bin_read_u64 (struct svf_bin_reader *r, uint64_t *v)
+{
+    uint32_t lo, hi;
+
+    if (bin_read_u32 (r, &lo) != URJ_STATUS_OK
+        || bin_read_u32 (r, &hi) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+    *v = ((uint64_t) hi << 32) | lo;
+
+    return URJ_STATUS_OK;
+}
+
+/* read a vector of tp->len bits as written by bin_write_packed */
+static int
+bin_read_packed (struct svf_bin_reader *r, urj_tap_packed_t *tp)
+{
+    const unsigned char *p = bin_read (r, BIN_BYTES (tp->len));
+    int i, n = BIN_BYTES (tp->len);
+
+    if (p == NULL)
+        return URJ_STATUS_FAIL;
+
+    memset (tp->data, 0, URJ_TAP_PACKED_WORDS (tp->len) * sizeof (uint64_t));
+    for (i = 0; i < n; i++)
+        tp->data[i / 8] |= (uint64_t) p[i] << (8 * (i % 8));
+    /* keep the bits above len clear for whole word compares */
+    if (tp->len % 64)
+        tp->data[URJ_TAP_PACKED_WORDS (tp->len) - 1] &=
+            ((uint64_t) 1 << (tp->len % 64)) - 1;
+
+    return URJ_STATUS_OK;
+}
+
+/* compare the captured TDO of the SVF part against the expected value */
+static int
+bin_check (struct svf_bin_pending *p)
+{
+    int i;
+
+    urj_tap_packed_from_bits (p->got, p->out + p->part_off);
+    if (urj_tap_packed_compare_masked (p->got, p->tdo, p->mask) == 0)
+        return URJ_STATUS_OK;
+
+    for (i = 0; i < p->got->len; i++)
+        if (URJ_TAP_PACKED_GET_BIT (p->mask, i)
+            && URJ_TAP_PACKED_GET_BIT (p->tdo, i)
+               != URJ_TAP_PACKED_GET_BIT (p->got, i))
+        {
+            /* positions count from the MSB like in the SVF player */
+            urj_log (URJ_LOG_LEVEL_NORMAL,
+                     _("Error %s: mismatch at position %d for TDO\n"), "svf",
+                     p->got->len - 1 - i);
+            urj_log (URJ_LOG_LEVEL_NORMAL, " in input file at line %d\n",
+                     (int) p->line);
+            return URJ_STATUS_FAIL;
+        }
+
+    return URJ_STATUS_OK;
+}
+
+static void
+bin_pending_free (struct svf_bin_pending *p)
+{
+    free (p->out);
+    urj_tap_packed_free (p->tdo);
+    urj_tap_packed_free (p->mask);
+    urj_tap_packed_free (p->got);
+    free (p);
+}
+
+/* collect and check queued TDO data until only keep checks are left */
+static int
+bin_drain (urj_chain_t *chain, struct svf_bin_pending **head, int *num,
+           int keep, int *mismatch)
+{
+    int result = URJ_STATUS_OK;
+
+    while (*num > keep)
+    {
+        struct svf_bin_pending *p = *head;
+
+        *head = p->next;
+        (*num)--;
+
+        urj_tap_cable_transfer_late (chain->cable, p->out);
+        p->out[p->len - 1] = urj_tap_cable_get_tdo_late (chain->cable);
+
+        if (bin_check (p) != URJ_STATUS_OK)
+        {
+            *mismatch = 1;
+            result = URJ_STATUS_FAIL;
+        }
+
+        bin_pending_free (p);
+    }
+
+    return result;
+}
+
+static int
+bin_corrupt (void)
+{
+    urj_error_set (URJ_ERROR_INVALID, _("%s: corrupt compiled file"), "svf");
+    return URJ_STATUS_FAIL;
+}
+
+static int
+bin_play (urj_chain_t *chain, struct svf_bin_reader *r, int stop_on_mismatch,
+          uint32_t ref_freq)
+{
+    struct svf_bin_pending *head = NULL, *tail = NULL;
+    int num = 0, mismatch = 0, result = URJ_STATUS_OK;
+    char *tdi = NULL;
+    urj_tap_packed_t *vec = NULL;
+    uint32_t op, n, i;
+
+    for (;;)
+    {
+        if (bin_read_u8 (r, &op) != URJ_STATUS_OK)
+        {
+            result = bin_corrupt ();
+            break;
+        }
+        if (op == URJ_SVF_BIN_END)
+            break;
+
+        switch (op)
+        {
+        case URJ_SVF_BIN_TMS:
+        {
+            const unsigned char *bits;
+
+            if (bin_read_u32 (r, &n) != URJ_STATUS_OK
+                || !(bits = bin_read (r, BIN_BYTES (n))))
+            {
+                result = bin_corrupt ();
+                break;
+            }
+            /* clock runs of equal TMS at once */
+            for (i = 0; i < n;)
+            {
+                int tms = BIN_GET_BIT (bits, i);
+                uint32_t run = 1;
+
+                while (i + run < n && BIN_GET_BIT (bits, i + run) == tms)
+                    run++;
+                urj_tap_chain_defer_clock (chain, tms, 0, run);
+                /* a reset the state machine can't follow from unknown */
+                if (tms && run >= 5)
+                    urj_tap_state_reset (chain);
+                i += run;
+            }
+            break;
+        }
+
+        case URJ_SVF_BIN_SHIFT:
+        {
+            uint32_t flags, len, line, part_off, part_len;
+            struct svf_bin_pending *p = NULL;
+
+            if (bin_read_u8 (r, &flags) != URJ_STATUS_OK
+                || bin_read_u32 (r, &len) != URJ_STATUS_OK
+                || bin_read_u32 (r, &line) != URJ_STATUS_OK
+                || bin_read_u32 (r, &part_off) != URJ_STATUS_OK
+                || bin_read_u32 (r, &part_len) != URJ_STATUS_OK
+                || len == 0 || len > INT_MAX
+                || part_off > len || part_len > len - part_off
+                || ((flags & URJ_SVF_BIN_SHIFT_TDO) && part_len == 0))
+            {
+                result = bin_corrupt ();
+                break;
+            }
+
+            /* reallocate the TDI vectors when the scan length changes */
+            if (vec == NULL || (uint32_t) vec->len != len)
+            {
+                char *t;
+
+                urj_tap_packed_free (vec);
+                if (!(vec = urj_tap_packed_alloc (len)))
+                {
+                    result = URJ_STATUS_FAIL;
+                    break;
+                }
+                if (!(t = realloc (tdi, len)))
+                {
+                    urj_error_set (URJ_ERROR_OUT_OF_MEMORY,
+                                   "realloc(%s,%zd) fails", "tdi",
+                                   (size_t) len);
+                    result = URJ_STATUS_FAIL;
+                    break;
+                }
+                tdi = t;
+            }
+            if (bin_read_packed (r, vec) != URJ_STATUS_OK)
+            {
+                result = bin_corrupt ();
+                break;
+            }
+            urj_tap_packed_to_bits (vec, tdi);
+
+            if (flags & URJ_SVF_BIN_SHIFT_TDO)
+            {
+                if (!(p = calloc (1, sizeof (struct svf_bin_pending)))
+                    || !(p->out = malloc (len))
+                    || !(p->tdo = urj_tap_packed_alloc (part_len))
+                    || !(p->mask = urj_tap_packed_alloc (part_len))
+                    || !(p->got = urj_tap_packed_alloc (part_len)))
+                {
+                    if (p)
+                        bin_pending_free (p);
+                    urj_error_set (URJ_ERROR_OUT_OF_MEMORY,
+                                   "malloc(%zd) fails", (size_t) len);
+                    result = URJ_STATUS_FAIL;
+                    break;
+                }
+                if (bin_read_packed (r, p->tdo) != URJ_STATUS_OK
+                    || bin_read_packed (r, p->mask) != URJ_STATUS_OK)
+                {
+                    bin_pending_free (p);
+                    result = bin_corrupt ();
+                    break;
+                }
+                p->len = len;
+                p->line = line;
+                p->part_off = part_off;
+            }
+
+            /* Shift-IR/DR, the last bit goes to Exit1-IR/DR */
+            urj_tap_cable_defer_transfer (chain->cable, len - 1, tdi,
+                                          p ? p->out : NULL);
+            if (p)
+                urj_tap_cable_defer_get_tdo (chain->cable);
+            urj_tap_chain_defer_clock (chain, 1, tdi[len - 1], 1);
+
+            if (p == NULL)
+                break;
+
+            if (tail)
+                tail->next = p;
+            else
+                head = p;
+            tail = p;
+            num++;
+
+            urj_tap_cable_flush (chain->cable, URJ_TAP_CABLE_OPTIONALLY);
+            if (bin_drain (chain, &head, &num, URJ_SVF_PIPELINE_DEPTH,
+                           &mismatch) != URJ_STATUS_OK && stop_on_mismatch)
+                result = URJ_STATUS_FAIL;
+            if (head == NULL)
+                tail = NULL;
+            break;
+        }
+
+        case URJ_SVF_BIN_RUNTEST:
+        {
+            uint64_t min_time, max_time;
+            uint32_t run_count, frequency;
+
+            if (bin_read_u32 (r, &run_count) != URJ_STATUS_OK
+                || bin_read_u64 (r, &min_time) != URJ_STATUS_OK
+                || bin_read_u64 (r, &max_time) != URJ_STATUS_OK)
+            {
+                result = bin_corrupt ();
+                break;
+            }
+
+            if (min_time > 0)
+            {
+                frequency = ref_freq > 0 ? ref_freq
+                            : urj_tap_cable_get_frequency (chain->cable);
+                if (frequency == 0)
+                {
+                    urj_error_set (URJ_ERROR_OUT_OF_BOUNDS,
+                                   _("Error %s: Maximum cable clock frequency required for RUNTEST"),
+                                   "svf");
+                    result = URJ_STATUS_FAIL;
+                    break;
+                }
+                n = ceil (min_time * 1e-9 * frequency);
+                if (n > run_count)
+                    run_count = n;
+            }
+
+            if (max_time > 0)
+            {
+                long double maxt = urj_lib_frealtime () + max_time * 1e-9;
+
+                while (run_count-- > 0 && urj_lib_frealtime () < maxt)
+                    urj_tap_chain_clock (chain, 0, 0, 1);
+            }
+            else
+                urj_tap_chain_defer_clock (chain, 0, 0, run_count);
+            break;
+        }
+
+        case URJ_SVF_BIN_FREQ:
+            if (bin_read_u32 (r, &n) != URJ_STATUS_OK)
+            {
+                result = bin_corrupt ();
+                break;
+            }
+            urj_tap_cable_set_frequency (chain->cable, n);
+            break;
+
+        case URJ_SVF_BIN_TRST:
+            if (bin_read_u8 (r, &n) != URJ_STATUS_OK)
+            {
+                result = bin_corrupt ();
+                break;
+            }
+            urj_tap_cable_set_signal (chain->cable, URJ_POD_CS_TRST,
+                                      n ? URJ_POD_CS_TRST : 0);
+            break;
+
+        default:
+            result = bin_corrupt ();
+            break;
+        }
+
+        if (result != URJ_STATUS_OK)
+            break;
+    }
+
+    /* evaluate the checks still in flight */
+    if (bin_drain (chain, &head, &num, 0, &mismatch) != URJ_STATUS_OK
+        && stop_on_mismatch)
+        result = URJ_STATUS_FAIL;
+
+    free (tdi);
+    urj_tap_packed_free (vec);
+
+    if (mismatch)
+        urj_log (URJ_LOG_LEVEL_DETAIL,
+                 _("Mismatches occurred between scanned device output and expected TDO values.\n"));
+    else
+        urj_log (URJ_LOG_LEVEL_DETAIL,
+                 _("Scanned device output matched expected TDO values.\n"));
+
+    return result;
+}
+
+
+int
+urj_svf_is_compiled (FILE *SVF_FILE)
+{
+    char magic[URJ_SVF_BIN_MAGIC_LEN];
+    int compiled;
+
+    rewind (SVF_FILE);
+    compiled = fread (magic, 1, sizeof magic, SVF_FILE) == sizeof magic
+               && memcmp (magic, URJ_SVF_BIN_MAGIC, sizeof magic) == 0;
+    rewind (SVF_FILE);
+
+    return compiled;
+}
+
+
+/* ***************************************************************************
+ * urj_svf_play(chain, SVF_FILE, stop_on_mismatch, ref_freq)
+ *
+ * Plays a file written by urj_svf_compile(). The file is mapped and its
+ * records are queued on the cable directly, TDO checks are evaluated
+ * late as with urj_svf_run_pipelined().
+ * ***************************************************************************/
+int
+urj_svf_play (urj_chain_t *chain, FILE *SVF_FILE, int stop_on_mismatch,
+              uint32_t ref_freq)
+{
+    struct svf_bin_reader r;
+    struct stat st;
+    unsigned char *map;
+    uint32_t old_frequency, num_parts, ir_len;
+    int i, result = URJ_STATUS_OK;
+
+    if (chain == NULL || chain->cable == NULL)
+        return URJ_STATUS_FAIL;
+    if (chain->parts == NULL)
+    {
+        urj_error_set (URJ_ERROR_NOTFOUND,
+                       _("%s: chain without any parts"), "svf");
+        return URJ_STATUS_FAIL;
+    }
+
+    if (fstat (fileno (SVF_FILE), &st) != 0)
+    {
+        urj_error_IO_set (_("%s: cannot stat compiled file"), "svf");
+        return URJ_STATUS_FAIL;
+    }
+    if (st.st_size < URJ_SVF_BIN_MAGIC_LEN)
+        return bin_corrupt ();
+
+#ifdef HAVE_MMAP
+    map = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE,
+                fileno (SVF_FILE), 0);
+    if (map == MAP_FAILED)
+    {
+        urj_error_IO_set (_("%s: cannot map compiled file"), "svf");
+        return URJ_STATUS_FAIL;
+    }
+#else
+    if (!(map = malloc (st.st_size)))
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "malloc(%zd) fails",
+                       (size_t) st.st_size);
+        return URJ_STATUS_FAIL;
+    }
+    rewind (SVF_FILE);
+    if (fread (map, 1, st.st_size, SVF_FILE) != (size_t) st.st_size)
+    {
+        urj_error_IO_set (_("%s: cannot read compiled file"), "svf");
+        free (map);
+        return URJ_STATUS_FAIL;
+    }
+#endif
+
+    r.pos = map;
+    r.end = map + st.st_size;
+
+    /* the stream is only valid for the chain it was compiled for */
+    if (memcmp (bin_read (&r, URJ_SVF_BIN_MAGIC_LEN), URJ_SVF_BIN_MAGIC,
+                URJ_SVF_BIN_MAGIC_LEN) != 0
+        || bin_read_u32 (&r, &num_parts) != URJ_STATUS_OK)
+        result = bin_corrupt ();
+    else if (num_parts != chain->parts->len)
+    {
+        urj_error_set (URJ_ERROR_INVALID,
+                       _("%s: file was compiled for %d parts, chain has %d"),
+                       "svf", (int) num_parts, chain->parts->len);
+        result = URJ_STATUS_FAIL;
+    }
+    for (i = 0; result == URJ_STATUS_OK && i < chain->parts->len; i++)
+    {
+        if (bin_read_u32 (&r, &ir_len) != URJ_STATUS_OK)
+            result = bin_corrupt ();
+        else if (ir_len != chain->parts->parts[i]->instruction_length)
+        {
+            urj_error_set (URJ_ERROR_INVALID,
+                           _("%s: file was compiled for a different chain (part %d)"),
+                           "svf", i);
+            result = URJ_STATUS_FAIL;
+        }
+    }
+
+    if (result == URJ_STATUS_OK)
+    {
+        old_frequency = urj_tap_cable_get_frequency (chain->cable);
+
+        result = bin_play (chain, &r, stop_on_mismatch, ref_freq);
+
+        /* restore previous frequency setting, required by SVF spec */
+        if (old_frequency != urj_tap_cable_get_frequency (chain->cable))
+            urj_tap_cable_set_frequency (chain->cable, old_frequency);
+    }
+
+#ifdef HAVE_MMAP
+    munmap (map, st.st_size);
+#else
+    free (map);
+#endif
+
+    return result;
+}
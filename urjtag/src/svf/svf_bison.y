@@ -119,12 +119,12 @@ svf_statement
 
     | FREQUENCY ';'
       {
-        urj_svf_frequency(chain, 0.0);
+        urj_svf_frequency(chain, priv_data, 0.0);
       }
 
     | FREQUENCY NUMBER HZ ';'
       {
-        urj_svf_frequency(chain, $2);
+        urj_svf_frequency(chain, priv_data, $2);
       }
 
     | HDR NUMBER ths_param_list ';'
@@ -63,6 +63,121 @@ urj_tap_cable_find (const char *cname)
     return urj_tap_cable_drivers[i];
 }
 
+/*
+ * Deferred transfers carry their in/out copies in slabs owned by the
+ * cable. Buffers are carved off the head slab; the slabs are recycled
+ * as a whole once no queued transfer uses them any more.
+ */
+#define URJ_CABLE_ARENA_SLAB    (64 * 1024)
+
+struct URJ_CABLE_ARENA
+{
+    urj_cable_arena_t *next;
+    size_t size;
+    size_t used;
+    char data[];
+};
+
+static char *
+cable_arena_alloc (urj_cable_t *cable, size_t len)
+{
+    urj_cable_arena_t *a = cable->arena;
+    char *p;
+
+    len = (len + 7) & ~(size_t) 7;
+
+    if (a == NULL || a->size - a->used < len)
+    {
+        size_t size = URJ_CABLE_ARENA_SLAB;
+
+        if (size < len)
+            size = len;
+        a = malloc (sizeof (urj_cable_arena_t) + size);
+        if (a == NULL)
+        {
+            urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "malloc(%zd) fails",
+                           sizeof (urj_cable_arena_t) + size);
+            return NULL;
+        }
+        a->next = cable->arena;
+        a->size = size;
+        a->used = 0;
+        cable->arena = a;
+    }
+
+    p = a->data + a->used;
+    a->used += len;
+
+    return p;
+}
+
+static int
+cable_arena_owns (const urj_cable_t *cable, const char *p)
+{
+    const urj_cable_arena_t *a;
+
+    for (a = cable->arena; a != NULL; a = a->next)
+        if (p >= a->data && p < a->data + a->size)
+            return 1;
+
+    return 0;
+}
+
+static void
+cable_arena_free (urj_cable_t *cable)
+{
+    while (cable->arena != NULL)
+    {
+        urj_cable_arena_t *a = cable->arena;
+
+        cable->arena = a->next;
+        free (a);
+    }
+}
+
+/* reset the arena when neither queue references it any more */
+static void
+cable_arena_recycle (urj_cable_t *cable)
+{
+    urj_cable_arena_t *a = cable->arena;
+    size_t total;
+    int i, n;
+
+    if (a == NULL || cable->todo.num_items > 0 || cable->pending > 0)
+        return;
+    if (a->used == 0 && a->next == NULL)
+        return;
+
+    for (i = cable->done.next_item, n = 0; n < cable->done.num_items; n++)
+    {
+        if (cable->done.data[i].action == URJ_TAP_CABLE_TRANSFER
+            && cable_arena_owns (cable, cable->done.data[i].arg.xferred.out))
+            return;
+        i++;
+        if (i >= cable->done.max_items)
+            i = 0;
+    }
+
+    if (a->next == NULL)
+    {
+        a->used = 0;
+        return;
+    }
+
+    /* it took several slabs, keep one that size for the next round */
+    for (total = 0; a != NULL; a = a->next)
+        total += a->size;
+    cable_arena_free (cable);
+    a = malloc (sizeof (urj_cable_arena_t) + total);
+    if (a != NULL)
+    {
+        a->next = NULL;
+        a->size = total;
+        a->used = 0;
+        cable->arena = a;
+    }
+}
+
 void
 urj_tap_cable_free (urj_cable_t *cable)
 {
@@ -74,6 +189,8 @@ urj_tap_cable_init (urj_cable_t *cable)
 {
     cable->delay = 0;
     cable->frequency = 0;
+    cable->arena = NULL;
+    cable->pending = 0;
 
     cable->todo.max_items = 128;
     cable->todo.num_items = 0;
@@ -109,6 +226,7 @@ void
 urj_tap_cable_flush (urj_cable_t *cable, urj_cable_flush_amount_t how_much)
 {
     cable->driver->flush (cable, how_much);
+    cable_arena_recycle (cable);
 }
 
 void
@@ -120,6 +238,7 @@ urj_tap_cable_done (urj_cable_t *cable)
         free (cable->todo.data);
         free (cable->done.data);
     }
+    cable_arena_free (cable);
     cable->driver->done (cable);
 }
 
@@ -136,7 +255,7 @@ urj_tap_cable_add_queue_item (urj_cable_t *cable, urj_cable_queue_info_t *q)
             "Queue %p needs resizing; n(%d) >= max(%d); free=%d, next=%d\n",
              q, q->num_items, q->max_items, q->next_free, q->next_item);
 
-        new_max_items = q->max_items + 128;
+        new_max_items = q->max_items * 2;
         resized = realloc (q->data, new_max_items * sizeof (urj_cable_queue_t));
         if (resized == NULL)
         {
@@ -271,14 +390,18 @@ urj_tap_cable_purge_queue (urj_cable_queue_info_t *q, int io)
         {
             if (io == 0)        /* todo queue */
             {
-                if (q->data[i].arg.transfer.in != NULL)
-                    free (q->data[i].arg.transfer.in);
-                if (q->data[i].arg.transfer.out != NULL)
-                    free (q->data[i].arg.transfer.out);
+                if (!q->data[i].arg.transfer.borrowed)
+                {
+                    if (q->data[i].arg.transfer.in != NULL)
+                        free (q->data[i].arg.transfer.in);
+                    if (q->data[i].arg.transfer.out != NULL)
+                        free (q->data[i].arg.transfer.out);
+                }
             }
             else                /* done queue */
             {
-                if (q->data[i].arg.xferred.out != NULL)
+                if (q->data[i].arg.xferred.out != NULL
+                    && !q->data[i].arg.xferred.borrowed)
                     free (q->data[i].arg.xferred.out);
             }
         }
@@ -447,6 +570,17 @@ urj_tap_cable_transfer_late (urj_cable_t *cable, char *out)
                 cable->done.data[i].arg.xferred.len,
                 cable->done.data[i].arg.xferred.out);
 #endif
+        if (cable->done.data[i].arg.xferred.borrowed)
+        {
+            /* arena copy, or the driver wrote straight into the
+             * caller's buffer */
+            if (out && out != cable->done.data[i].arg.xferred.out)
+                memcpy (out,
+                        cable->done.data[i].arg.xferred.out,
+                        cable->done.data[i].arg.xferred.len);
+            cable_arena_recycle (cable);
+            return cable->done.data[i].arg.xferred.res;
+        }
         if (out)
             memcpy (out,
                     cable->done.data[i].arg.xferred.out,
@@ -477,34 +611,16 @@ urj_tap_cable_defer_transfer (urj_cable_t *cable, int len, char *in,
     char *ibuf, *obuf = NULL;
     int i;
 
-    ibuf = malloc (len);
+    /* in and out copies share one arena block */
+    ibuf = cable_arena_alloc (cable, out ? 2 * (size_t) len : (size_t) len);
     if (ibuf == NULL)
-    {
-        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "malloc(%zd) fails",
-                       (size_t) len);
         return URJ_STATUS_FAIL;
-    }
-
     if (out)
-    {
-        obuf = malloc (len);
-        if (obuf == NULL)
-        {
-            free (ibuf);
-            urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "malloc(%zd) fails",
-                           (size_t) len);
-            return URJ_STATUS_FAIL;
-        }
-    }
+        obuf = ibuf + len;
 
     i = urj_tap_cable_add_queue_item (cable, &cable->todo);
     if (i < 0)
-    {
-        free (ibuf);
-        if (obuf)
-            free (obuf);
         return URJ_STATUS_FAIL;               /* report failure */
-    }
 
     cable->todo.data[i].action = URJ_TAP_CABLE_TRANSFER;
     cable->todo.data[i].arg.transfer.len = len;
@@ -512,6 +628,32 @@ urj_tap_cable_defer_transfer (urj_cable_t *cable, int len, char *in,
         memcpy (ibuf, in, len);
     cable->todo.data[i].arg.transfer.in = ibuf;
     cable->todo.data[i].arg.transfer.out = obuf;
+    cable->todo.data[i].arg.transfer.borrowed = 1;
+    urj_tap_cable_flush (cable, URJ_TAP_CABLE_OPTIONALLY);
+    return URJ_STATUS_OK;                   /* success */
+}
+
+int
+urj_tap_cable_defer_transfer_nocopy (urj_cable_t *cable, int len, char *in,
+                                     char *out)
+{
+    int i;
+
+    if (in == NULL)
+    {
+        urj_error_set (URJ_ERROR_INVALID, "in == NULL");
+        return URJ_STATUS_FAIL;
+    }
+
+    i = urj_tap_cable_add_queue_item (cable, &cable->todo);
+    if (i < 0)
+        return URJ_STATUS_FAIL;               /* report failure */
+
+    cable->todo.data[i].action = URJ_TAP_CABLE_TRANSFER;
+    cable->todo.data[i].arg.transfer.len = len;
+    cable->todo.data[i].arg.transfer.in = in;
+    cable->todo.data[i].arg.transfer.out = out;
+    cable->todo.data[i].arg.transfer.borrowed = 1;
     urj_tap_cable_flush (cable, URJ_TAP_CABLE_OPTIONALLY);
     return URJ_STATUS_OK;                   /* success */
 }
@@ -683,6 +825,9 @@ static const urj_param_descr_t cable_param[] =
     { URJ_CABLE_PARAM_KEY_INTERFACE,    URJ_PARAM_TYPE_LU,      "interface", },
     { URJ_CABLE_PARAM_KEY_FIRMWARE,     URJ_PARAM_TYPE_STRING,  "firmware", },
     { URJ_CABLE_PARAM_KEY_INDEX,        URJ_PARAM_TYPE_LU,      "index", },
+    { URJ_CABLE_PARAM_KEY_BAUD,         URJ_PARAM_TYPE_LU,      "baud", },
+    { URJ_CABLE_PARAM_KEY_ASYNC,        URJ_PARAM_TYPE_LU,      "async", },
+    { URJ_CABLE_PARAM_KEY_THREAD,       URJ_PARAM_TYPE_LU,      "thread", },
 };
 
 const urj_param_list_t urj_cable_param_list =
@@ -42,7 +42,9 @@
 #include "usbconn/libftdx.h"
 
 
+/* rate the firmware starts with, and the one we ask for by default */
 const int BAUD_RATE = 115200;
+#define BAUD_RATE_FAST 1000000
 
 const uint8_t CMD_RESET  = 0x74;
 const uint8_t CMD_STATUS = 0x3F;
@@ -50,6 +52,22 @@ const uint8_t CMD_GETVER = 0x61;
 const uint8_t CMD_SEND   = 0x73;
 const uint8_t CMD_READ   = 0x72;
 const uint8_t CMD_FORCE  = 0x66;
+const uint8_t CMD_SHIFT  = 0x78;
+const uint8_t CMD_STREAM = 0x71;
+const uint8_t CMD_SYNC   = 0x79;
+const uint8_t CMD_BAUD   = 0x62;
+const uint8_t CMD_DELAY  = 0x64;
+
+/* largest CMD_SHIFT payload, keeps one command inside the 64 byte
+ * receive buffer of the Arduino serial port */
+#define SHIFT_MAX_BYTES 32
+#define SHIFT_MAX_BITS  (SHIFT_MAX_BYTES * 8)
+/* CMD_SHIFT bit count flag: do not send TDO bytes back */
+#define SHIFT_NO_TDO    0x8000
+
+/* nobody waits for the commands of a CMD_STREAM batch, so a batch
+ * including its CMD_SYNC has to fit the receive buffer as well */
+#define STREAM_MAX_BYTES 60
 
 const int STATUS_OK   = 0x6F6B;
 const int STATUS_ERR1 = 0x6531;
@@ -59,6 +77,11 @@ const int STATUS_ERR2 = 0x6532;
 typedef struct
 {
   urj_tap_cable_cx_cmd_root_t cmd_root;
+  int has_shift;                /* firmware >= 2.10 knows CMD_SHIFT */
+  int has_stream;               /* firmware >= 2.20 knows CMD_STREAM/CMD_SYNC */
+  int pending;                  /* bytes queued in the open stream batch */
+  int has_tune;                 /* firmware >= 2.30 knows CMD_BAUD/CMD_DELAY */
+  uint32_t baud_rate;           /* UART rate to switch to in init */
 } params_t;
 
 
@@ -77,6 +100,90 @@ arduiggler_get_status (urj_cable_t *cable)
     return ar_status;
 }
 
+static int
+arduiggler_send (urj_cable_t *cable)
+{
+    params_t *params = cable->params;
+    urj_tap_cable_cx_cmd_root_t *cmd_root = &params->cmd_root;
+
+    /* the caller reads its reply bytes, then the (batch) status */
+    if (params->pending)
+    {
+        urj_tap_cable_cx_cmd_push (cmd_root, CMD_SYNC);
+        params->pending = 0;
+    }
+    urj_tap_cable_cx_xfer (cmd_root, NULL, cable, URJ_TAP_CABLE_COMPLETELY);
+
+    return URJ_STATUS_OK;
+}
+
+static int
+arduiggler_sync (urj_cable_t *cable)
+{
+    params_t *params = cable->params;
+    int ar_status;
+
+    if (!params->pending)
+        return URJ_STATUS_OK;
+
+    arduiggler_send (cable);
+    ar_status = arduiggler_get_status (cable);
+    if (ar_status != STATUS_OK)
+    {
+        urj_log (URJ_LOG_LEVEL_WARNING, "arduiggler_sync - ar_status = %X\n", ar_status);
+        return URJ_STATUS_FAIL;
+    }
+
+    return URJ_STATUS_OK;
+}
+
+/* start a command of len bytes; in stream mode it is appended to the
+ * open batch, a full batch is synced first */
+static void
+arduiggler_begin (urj_cable_t *cable, int len)
+{
+    params_t *params = cable->params;
+    urj_tap_cable_cx_cmd_root_t *cmd_root = &params->cmd_root;
+
+    if (!params->has_stream)
+    {
+        urj_tap_cable_cx_cmd_queue (cmd_root, 0);
+        return;
+    }
+
+    if (params->pending + len + 1 > STREAM_MAX_BYTES)
+        arduiggler_sync (cable);
+
+    if (!params->pending)
+    {
+        urj_tap_cable_cx_cmd_queue (cmd_root, 0);
+        urj_tap_cable_cx_cmd_push (cmd_root, CMD_STREAM);
+        params->pending = 1;
+    }
+    params->pending += len;
+}
+
+/* finish a command without reply data and wait for its status */
+static int
+arduiggler_post (urj_cable_t *cable)
+{
+    params_t *params = cable->params;
+    int ar_status;
+
+    if (params->has_stream)
+        return arduiggler_sync (cable);
+
+    arduiggler_send (cable);
+    ar_status = arduiggler_get_status (cable);
+    if (ar_status != STATUS_OK)
+    {
+        urj_log (URJ_LOG_LEVEL_WARNING, "arduiggler_post - ar_status = %X\n", ar_status);
+        return URJ_STATUS_FAIL;
+    }
+
+    return URJ_STATUS_OK;
+}
+
 static int
 arduiggler_connect (urj_cable_t *cable, const urj_param_t *params[])
 {
@@ -101,6 +208,24 @@ arduiggler_connect (urj_cable_t *cable, const urj_param_t *params[])
     }
 
     urj_tap_cable_cx_cmd_init (&cable_params->cmd_root);
+    cable_params->has_shift = 0;
+    cable_params->has_stream = 0;
+    cable_params->pending = 0;
+    cable_params->has_tune = 0;
+    cable_params->baud_rate = BAUD_RATE_FAST;
+
+    if (params != NULL)
+        for (int i = 0; params[i] != NULL; i++)
+        {
+            switch (params[i]->key)
+            {
+            case URJ_CABLE_PARAM_KEY_BAUD:
+                cable_params->baud_rate = params[i]->value.lu;
+                break;
+            default:
+                break;
+            }
+        }
 
     /* exchange generic cable parameters with our private parameter set */
     free (cable->params);
@@ -109,6 +234,87 @@ arduiggler_connect (urj_cable_t *cable, const urj_param_t *params[])
     return URJ_STATUS_OK;
 }
 
+static void
+arduiggler_set_frequency (urj_cable_t *cable, uint32_t new_frequency)
+{
+    params_t *params = cable->params;
+    urj_tap_cable_cx_cmd_root_t *cmd_root = &params->cmd_root;
+    uint32_t delay;
+
+    if (!params->has_tune)
+    {
+        if (new_frequency)
+            urj_warning (_("Arduiggler firmware does not support configurable frequency\n"));
+        return;
+    }
+
+    /* firmware waits delay us in each TCK half period, 0 is full speed */
+    if (new_frequency == 0 || new_frequency > 500000)
+        delay = 0;
+    else
+        delay = (500000 + new_frequency - 1) / new_frequency;
+    if (delay > 0xffff)
+        delay = 0xffff;
+
+    arduiggler_begin (cable, 3);
+    urj_tap_cable_cx_cmd_push (cmd_root, CMD_DELAY);
+    urj_tap_cable_cx_cmd_push (cmd_root, (uint8_t)(delay >> 8));
+    urj_tap_cable_cx_cmd_push (cmd_root, (uint8_t)delay);
+    if (arduiggler_post (cable) != URJ_STATUS_OK)
+        return;
+
+    cable->frequency = delay ? 500000 / delay : 0;
+}
+
+/* switch firmware and FT232 to rate; the status of CMD_BAUD still comes
+ * at the old rate */
+static int
+arduiggler_set_baudrate (urj_cable_t *cable, uint32_t rate)
+{
+    params_t *params = cable->params;
+    urj_tap_cable_cx_cmd_root_t *cmd_root = &params->cmd_root;
+    ftdi_param_t *fp = cable->link.usb->params;
+    int ar_status;
+
+    urj_tap_cable_cx_cmd_queue (cmd_root, 0);
+    urj_tap_cable_cx_cmd_push (cmd_root, CMD_BAUD);
+    urj_tap_cable_cx_cmd_push (cmd_root, (uint8_t)(rate >> 24));
+    urj_tap_cable_cx_cmd_push (cmd_root, (uint8_t)(rate >> 16));
+    urj_tap_cable_cx_cmd_push (cmd_root, (uint8_t)(rate >> 8));
+    urj_tap_cable_cx_cmd_push (cmd_root, (uint8_t)rate);
+    urj_tap_cable_cx_xfer (cmd_root, NULL, cable, URJ_TAP_CABLE_COMPLETELY);
+
+    ar_status = arduiggler_get_status (cable);
+    if (ar_status != STATUS_OK)
+    {
+        urj_warning (_("cable refused baud rate %lu\n"), (unsigned long) rate);
+        return URJ_STATUS_OK;
+    }
+
+    if (ftdi_set_baudrate (fp->fc, rate) != 0)
+    {
+        urj_warning (_("cannot change baud rate\n"));
+        return URJ_STATUS_FAIL;
+    }
+
+    /* make sure both ends talk at the new rate */
+    urj_tap_cable_cx_cmd_queue (cmd_root, 0);
+    urj_tap_cable_cx_cmd_push (cmd_root, CMD_STATUS);
+    urj_tap_cable_cx_xfer (cmd_root, NULL, cable, URJ_TAP_CABLE_COMPLETELY);
+
+    ar_status = arduiggler_get_status (cable);
+    if (ar_status != STATUS_OK)
+    {
+        urj_warning (_("cable lost at baud rate %lu\n"), (unsigned long) rate);
+        return URJ_STATUS_FAIL;
+    }
+
+    urj_log (URJ_LOG_LEVEL_NORMAL, "Arduiggler baud rate: %lu\n",
+             (unsigned long) rate);
+
+    return URJ_STATUS_OK;
+}
+
 static int
 arduiggler_init (urj_cable_t *cable)
 {
@@ -151,13 +357,23 @@ arduiggler_init (urj_cable_t *cable)
     }
     urj_log (URJ_LOG_LEVEL_NORMAL, "Arduiggler firmware: %s\n", ar_swver);
 
+    /* packed shifts came with firmware 2.10, batched status with 2.20 */
+    params->has_shift = (strcmp (ar_swver, "2.10") >= 0);
+    params->has_stream = (strcmp (ar_swver, "2.20") >= 0);
+    params->has_tune = (strcmp (ar_swver, "2.30") >= 0);
+
     ar_status = arduiggler_get_status(cable);
 
     if (ar_status != STATUS_OK) {
         urj_warning (_("cable not initialized properly\n"));
         return URJ_STATUS_FAIL;
     }
-    //arduiggler_set_frequency (cable, 0);
+
+    if (params->has_tune && params->baud_rate != BAUD_RATE
+        && arduiggler_set_baudrate (cable, params->baud_rate) != URJ_STATUS_OK)
+        return URJ_STATUS_FAIL;
+
+    arduiggler_set_frequency (cable, cable->frequency);
 
     return URJ_STATUS_OK;
 }
@@ -172,16 +388,11 @@ arduiggler_cable_free (urj_cable_t *cable)
 }
 
 static void
-arduiggler_set_frequency (urj_cable_t *cable, uint32_t new_frequency)
-{
-  urj_warning (_("Arduiggler does not support configurable frequency\n"));
-}
-
-static void
-arduiggler_clock (urj_cable_t *cable, int tms, int tdi, int n)
+arduiggler_clock_schedule (urj_cable_t *cable, int tms, int tdi, int n)
 {
+    params_t *params = cable->params;
+    urj_tap_cable_cx_cmd_root_t *cmd_root = &params->cmd_root;
     uint8_t ar_data;
-    int ar_clk = n;
 
     if (tdi)
       ar_data = URJ_POD_CS_TDI;
@@ -191,37 +402,25 @@ arduiggler_clock (urj_cable_t *cable, int tms, int tdi, int n)
     if(tms)
       ar_data |= URJ_POD_CS_TMS;
 
-    params_t *params = cable->params;
-    urj_tap_cable_cx_cmd_root_t *cmd_root = &params->cmd_root;
-    int ar_status;
-
-    while(ar_clk > UCHAR_MAX) {
-      urj_tap_cable_cx_cmd_queue (cmd_root, 0);
-      urj_tap_cable_cx_cmd_push (cmd_root, CMD_SEND);
-      urj_tap_cable_cx_cmd_push (cmd_root, ar_data);
-      urj_tap_cable_cx_cmd_push (cmd_root, UCHAR_MAX);
-      urj_tap_cable_cx_xfer (cmd_root, NULL, cable, URJ_TAP_CABLE_COMPLETELY);
+    urj_tap_cable_cx_cmd_push (cmd_root, CMD_SEND);
+    urj_tap_cable_cx_cmd_push (cmd_root, ar_data);
+    urj_tap_cable_cx_cmd_push (cmd_root, (uint8_t)n);
+}
 
-      ar_status = arduiggler_get_status(cable);
-      if (ar_status != STATUS_OK) {
-        urj_log (URJ_LOG_LEVEL_WARNING, "arduiggler_clock - ar_status = %X\n", ar_status);
-        return;
-      }
-      ar_clk -= UCHAR_MAX;
-    }
+static void
+arduiggler_clock (urj_cable_t *cable, int tms, int tdi, int n)
+{
+    int ar_clk;
 
-    if(ar_clk > 0) {
-      urj_tap_cable_cx_cmd_queue (cmd_root, 0);
-      urj_tap_cable_cx_cmd_push (cmd_root, CMD_SEND);
-      urj_tap_cable_cx_cmd_push (cmd_root, ar_data);
-      urj_tap_cable_cx_cmd_push (cmd_root, (uint8_t)ar_clk);
-      urj_tap_cable_cx_xfer (cmd_root, NULL, cable, URJ_TAP_CABLE_COMPLETELY);
+    while(n > 0) {
+      ar_clk = (n > UCHAR_MAX) ? UCHAR_MAX : n;
 
-      ar_status = arduiggler_get_status(cable);
-      if (ar_status != STATUS_OK) {
-        urj_log (URJ_LOG_LEVEL_WARNING, "arduiggler_clock - ar_status = %X\n", ar_status);
+      arduiggler_begin (cable, 3);
+      arduiggler_clock_schedule (cable, tms, tdi, ar_clk);
+      if (arduiggler_post (cable) != URJ_STATUS_OK)
         return;
-      }
+
+      n -= ar_clk;
     }
 }
 
@@ -231,9 +430,9 @@ arduiggler_get_tdo (urj_cable_t *cable)
     params_t *params = cable->params;
     urj_tap_cable_cx_cmd_root_t *cmd_root = &params->cmd_root;
 
-    urj_tap_cable_cx_cmd_queue (cmd_root, 0);
+    arduiggler_begin (cable, 1);
     urj_tap_cable_cx_cmd_push (cmd_root, CMD_READ);
-    urj_tap_cable_cx_xfer (cmd_root, NULL, cable, URJ_TAP_CABLE_COMPLETELY);
+    arduiggler_send (cable);
 
     uint8_t ar_rply = urj_tap_cable_cx_xfer_recv (cable);
 
@@ -246,6 +445,97 @@ arduiggler_get_tdo (urj_cable_t *cable)
     return tdo;
 }
 
+/* bytes one CMD_SHIFT of chunk bits occupies on the wire */
+#define SHIFT_CMD_LEN(chunk) (3 + ((chunk) + 7) / 8)
+
+static void
+arduiggler_shift_schedule (urj_cable_t *cable, int chunk, const char *in,
+                           int want_tdo)
+{
+    params_t *params = cable->params;
+    urj_tap_cable_cx_cmd_root_t *cmd_root = &params->cmd_root;
+    unsigned int count = chunk;
+    uint8_t data;
+    int bit, i;
+
+    if (!want_tdo)
+        count |= SHIFT_NO_TDO;
+
+    urj_tap_cable_cx_cmd_push (cmd_root, CMD_SHIFT);
+    urj_tap_cable_cx_cmd_push (cmd_root, (uint8_t)(count >> 8));
+    urj_tap_cable_cx_cmd_push (cmd_root, (uint8_t)count);
+
+    /* TDI bits packed LSB first */
+    for (i = 0; i < chunk; i += 8)
+    {
+        data = 0;
+        for (bit = 0; bit < 8 && i + bit < chunk; bit++)
+            if (in[i + bit])
+                data |= 1 << bit;
+        urj_tap_cable_cx_cmd_push (cmd_root, data);
+    }
+}
+
+static void
+arduiggler_shift_finish (urj_cable_t *cable, int chunk, char *out)
+{
+    uint8_t data;
+    int bit, i;
+
+    /* TDO bits come back packed the same way */
+    for (i = 0; i < chunk; i += 8)
+    {
+        data = urj_tap_cable_cx_xfer_recv (cable);
+        if (out)
+            for (bit = 0; bit < 8 && i + bit < chunk; bit++)
+                out[i + bit] = (data >> bit) & 1;
+    }
+}
+
+static int
+arduiggler_transfer (urj_cable_t *cable, int len, const char *in, char *out)
+{
+    params_t *params = cable->params;
+    int pos, chunk;
+    int want_tdo;
+    int ar_status;
+
+    if (!params->has_shift)
+        return urj_tap_cable_generic_transfer (cable, len, in, out);
+
+    /* without stream mode the TDO bytes are needed for lockstep anyway */
+    want_tdo = out || !params->has_stream;
+
+    for (pos = 0; pos < len; pos += chunk)
+    {
+        chunk = len - pos;
+        if (chunk > SHIFT_MAX_BITS)
+            chunk = SHIFT_MAX_BITS;
+
+        arduiggler_begin (cable, SHIFT_CMD_LEN (chunk));
+        arduiggler_shift_schedule (cable, chunk, in + pos, want_tdo);
+
+        if (!want_tdo)
+        {
+            if (arduiggler_post (cable) != URJ_STATUS_OK)
+                return -1;
+            continue;
+        }
+
+        arduiggler_send (cable);
+        arduiggler_shift_finish (cable, chunk, out ? out + pos : NULL);
+
+        ar_status = arduiggler_get_status (cable);
+        if (ar_status != STATUS_OK)
+        {
+            urj_log (URJ_LOG_LEVEL_WARNING, "arduiggler_transfer - ar_status = %X\n", ar_status);
+            return -1;
+        }
+    }
+
+    return len;
+}
+
 static int
 arduiggler_set_signal (urj_cable_t *cable, int mask, int val)
 {
@@ -258,10 +548,11 @@ arduiggler_set_signal (urj_cable_t *cable, int mask, int val)
         URJ_POD_CS_TCK |
         URJ_POD_CS_TDI );
 
-    urj_tap_cable_cx_cmd_queue (cmd_root, 0);
+    /* callers time resets around this, always wait for the status */
+    arduiggler_begin (cable, 2);
     urj_tap_cable_cx_cmd_push (cmd_root, CMD_FORCE);
     urj_tap_cable_cx_cmd_push (cmd_root, (uint8_t)(val & mask));
-    urj_tap_cable_cx_xfer (cmd_root, NULL, cable, URJ_TAP_CABLE_COMPLETELY);
+    arduiggler_send (cable);
 
     int ar_status = arduiggler_get_status(cable);
     //TODO: handle cable failure
@@ -270,6 +561,213 @@ arduiggler_set_signal (urj_cable_t *cable, int mask, int val)
     return 0;
 }
 
+/* bytes a queued action occupies in a stream batch */
+static int
+arduiggler_schedule_len (urj_cable_queue_t *item)
+{
+    int len, n;
+
+    switch (item->action)
+    {
+    case URJ_TAP_CABLE_CLOCK:
+        return 3 * ((item->arg.clock.n + UCHAR_MAX - 1) / UCHAR_MAX);
+    case URJ_TAP_CABLE_GET_TDO:
+        return 1;
+    case URJ_TAP_CABLE_SET_SIGNAL:
+        return 2;
+    case URJ_TAP_CABLE_TRANSFER:
+        len = 0;
+        for (n = item->arg.transfer.len; n > SHIFT_MAX_BITS; n -= SHIFT_MAX_BITS)
+            len += SHIFT_CMD_LEN (SHIFT_MAX_BITS);
+        return len + SHIFT_CMD_LEN (n);
+    default:
+        return 0;
+    }
+}
+
+static void
+arduiggler_schedule (urj_cable_t *cable, urj_cable_queue_t *item)
+{
+    params_t *params = cable->params;
+    urj_tap_cable_cx_cmd_root_t *cmd_root = &params->cmd_root;
+    int n, chunk, mask;
+
+    switch (item->action)
+    {
+    case URJ_TAP_CABLE_CLOCK:
+        for (n = item->arg.clock.n; n > 0; n -= chunk)
+        {
+            chunk = (n > UCHAR_MAX) ? UCHAR_MAX : n;
+            arduiggler_clock_schedule (cable, item->arg.clock.tms,
+                                       item->arg.clock.tdi, chunk);
+        }
+        break;
+    case URJ_TAP_CABLE_GET_TDO:
+        urj_tap_cable_cx_cmd_push (cmd_root, CMD_READ);
+        break;
+    case URJ_TAP_CABLE_SET_SIGNAL:
+        mask = item->arg.value.mask & ( URJ_POD_CS_RESET |
+            URJ_POD_CS_TRST |
+            URJ_POD_CS_TMS |
+            URJ_POD_CS_TCK |
+            URJ_POD_CS_TDI );
+        urj_tap_cable_cx_cmd_push (cmd_root, CMD_FORCE);
+        urj_tap_cable_cx_cmd_push (cmd_root, (uint8_t)(item->arg.value.val & mask));
+        break;
+    case URJ_TAP_CABLE_TRANSFER:
+        for (n = 0; n < item->arg.transfer.len; n += chunk)
+        {
+            chunk = item->arg.transfer.len - n;
+            if (chunk > SHIFT_MAX_BITS)
+                chunk = SHIFT_MAX_BITS;
+            arduiggler_shift_schedule (cable, chunk, item->arg.transfer.in + n,
+                                       item->arg.transfer.out != NULL);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static void
+arduiggler_finish (urj_cable_t *cable, urj_cable_queue_t *item)
+{
+    int n, chunk, m;
+
+    switch (item->action)
+    {
+    case URJ_TAP_CABLE_GET_TDO:
+        m = urj_tap_cable_add_queue_item (cable, &cable->done);
+        cable->done.data[m].action = URJ_TAP_CABLE_GET_TDO;
+        cable->done.data[m].arg.value.val =
+            urj_tap_cable_cx_xfer_recv (cable) & 0x01;
+        break;
+    case URJ_TAP_CABLE_GET_SIGNAL:
+        m = urj_tap_cable_add_queue_item (cable, &cable->done);
+        cable->done.data[m].action = URJ_TAP_CABLE_GET_SIGNAL;
+        cable->done.data[m].arg.value.sig = item->arg.value.sig;
+        cable->done.data[m].arg.value.val =
+            cable->driver->get_signal (cable, item->arg.value.sig);
+        break;
+    case URJ_TAP_CABLE_TRANSFER:
+        if (item->arg.transfer.out)
+        {
+            for (n = 0; n < item->arg.transfer.len; n += chunk)
+            {
+                chunk = item->arg.transfer.len - n;
+                if (chunk > SHIFT_MAX_BITS)
+                    chunk = SHIFT_MAX_BITS;
+                arduiggler_shift_finish (cable, chunk,
+                                         item->arg.transfer.out + n);
+            }
+            m = urj_tap_cable_add_queue_item (cable, &cable->done);
+            cable->done.data[m].action = URJ_TAP_CABLE_TRANSFER;
+            cable->done.data[m].arg.xferred.len = item->arg.transfer.len;
+            cable->done.data[m].arg.xferred.res = item->arg.transfer.len;
+            cable->done.data[m].arg.xferred.out = item->arg.transfer.out;
+            cable->done.data[m].arg.xferred.borrowed = item->arg.transfer.borrowed;
+        }
+        if (!item->arg.transfer.borrowed)
+            free (item->arg.transfer.in);
+        break;
+    default:
+        break;
+    }
+}
+
+static void
+arduiggler_flush (urj_cable_t *cable, urj_cable_flush_amount_t how_much)
+{
+    params_t *params = cable->params;
+
+    if (!params->has_stream)
+    {
+        urj_tap_cable_generic_flush_one_by_one (cable, how_much);
+        return;
+    }
+
+    if (how_much == URJ_TAP_CABLE_OPTIONALLY)
+        return;
+
+    while (cable->todo.num_items > 0)
+    {
+        int i, j, n, len;
+        int ar_status;
+
+        /* Step 1: encode as many queued actions as fit one stream batch */
+        for (j = i = cable->todo.next_item, n = 0; n < cable->todo.num_items;
+             n++)
+        {
+            len = arduiggler_schedule_len (&cable->todo.data[i]);
+            if ((params->pending ? params->pending : 1) + len + 1
+                > STREAM_MAX_BYTES)
+                break;
+
+            if (len > 0)
+            {
+                arduiggler_begin (cable, len);
+                arduiggler_schedule (cable, &cable->todo.data[i]);
+            }
+
+            i++;
+            if (i >= cable->todo.max_items)
+                i = 0;
+        }
+
+        if (n == 0)
+        {
+            /* a single action too large for one batch, the direct
+             * driver functions split it up */
+            urj_cable_queue_t *item;
+
+            item = &cable->todo.data[urj_tap_cable_get_queue_item (cable, &cable->todo)];
+            if (item->action == URJ_TAP_CABLE_CLOCK)
+                arduiggler_clock (cable, item->arg.clock.tms,
+                                  item->arg.clock.tdi, item->arg.clock.n);
+            else if (item->action == URJ_TAP_CABLE_TRANSFER)
+            {
+                int m, r;
+
+                r = arduiggler_transfer (cable, item->arg.transfer.len,
+                                         item->arg.transfer.in,
+                                         item->arg.transfer.out);
+                if (!item->arg.transfer.borrowed)
+                    free (item->arg.transfer.in);
+                if (item->arg.transfer.out)
+                {
+                    m = urj_tap_cable_add_queue_item (cable, &cable->done);
+                    cable->done.data[m].action = URJ_TAP_CABLE_TRANSFER;
+                    cable->done.data[m].arg.xferred.len = item->arg.transfer.len;
+                    cable->done.data[m].arg.xferred.res = r;
+                    cable->done.data[m].arg.xferred.out = item->arg.transfer.out;
+                    cable->done.data[m].arg.xferred.borrowed = item->arg.transfer.borrowed;
+                }
+            }
+            continue;
+        }
+
+        /* Step 2: one burst out, then pick up the replies in queue order */
+        if (params->pending)
+        {
+            arduiggler_send (cable);
+            for (; j != i; j = (j + 1) % cable->todo.max_items)
+                arduiggler_finish (cable, &cable->todo.data[j]);
+            ar_status = arduiggler_get_status (cable);
+            if (ar_status != STATUS_OK)
+                urj_log (URJ_LOG_LEVEL_WARNING, "arduiggler_flush - ar_status = %X\n", ar_status);
+        }
+        else
+        {
+            /* nothing went on the wire, e.g. only GET_SIGNAL */
+            for (; j != i; j = (j + 1) % cable->todo.max_items)
+                arduiggler_finish (cable, &cable->todo.data[j]);
+        }
+
+        cable->todo.next_item = i;
+        cable->todo.num_items -= n;
+    }
+}
+
 const const urj_cable_driver_t urj_tap_cable_arduiggler_driver = {
     "Arduiggler",
     N_("Arduino JTAG USB Cable (FT232)"),
@@ -282,10 +780,10 @@ const const urj_cable_driver_t urj_tap_cable_arduiggler_driver = {
     arduiggler_set_frequency,
     arduiggler_clock,
     arduiggler_get_tdo,
-    urj_tap_cable_generic_transfer, // TODO
+    arduiggler_transfer,
     arduiggler_set_signal,
     urj_tap_cable_generic_get_signal, // TODO
-    urj_tap_cable_generic_flush_one_by_one,
+    arduiggler_flush,
     urj_tap_cable_generic_usbconn_help
 };
 URJ_DECLARE_FTDX_CABLE(0x0403, 0x6001, "", "arduiggler", arduiggler)
@@ -32,6 +32,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
 
 #include <urjtag/cable.h>
 #include <urjtag/chain.h>
@@ -242,6 +245,10 @@
 #define BITMASK_MILKYMIST_VREF (1 << BIT_MILKYMIST_VREF)
 
 
+#ifdef HAVE_PTHREAD
+typedef struct ft2232_worker ft2232_worker_t;
+#endif
+
 typedef struct
 {
     uint32_t mpsse_frequency;
@@ -275,6 +282,11 @@ typedef struct
     int signals;
 
     urj_tap_cable_cx_cmd_root_t cmd_root;
+
+#ifdef HAVE_PTHREAD
+    /* flush thread, NULL unless requested with thread=1 */
+    ft2232_worker_t *worker;
+#endif
 } params_t;
 
 
@@ -1948,58 +1960,60 @@ ft2232_transfer (urj_cable_t *cable, int len, const char *in, char *out)
 }
 
 
+/* encode and run the items of todo, results go to done; unless complete is
+   set a trailing partial clock byte is kept in todo to merge with later
+   clocks */
 static void
-ft2232_flush (urj_cable_t *cable, urj_cable_flush_amount_t how_much)
+ft2232_flush_queue (urj_cable_t *cable, urj_cable_queue_info_t *todo,
+                    urj_cable_queue_info_t *done,
+                    urj_cable_flush_amount_t how_much, int complete)
 {
     params_t *params = cable->params;
 
-    if (how_much == URJ_TAP_CABLE_OPTIONALLY)
-        return;
-
-    if (cable->todo.num_items == 0)
+    if (todo->num_items == 0)
         urj_tap_cable_cx_xfer (&params->cmd_root, &imm_cmd, cable,
                                how_much);
 
-    while (cable->todo.num_items > 0)
+    while (todo->num_items > 0)
     {
         int i, j, n;
+        int kept = 0;
         int post_signals = params->signals;
         int last_tdo_valid_schedule = params->last_tdo_valid;
         int last_tdo_valid_finish = params->last_tdo_valid;
 
-        if (cable->todo.num_items == 1
-            && cable->todo.data[cable->todo.next_item].action
+        if (todo->num_items == 1
+            && todo->data[todo->next_item].action
                == URJ_TAP_CABLE_CLOCK_COMPACT
-            && how_much != URJ_TAP_CABLE_COMPLETELY)
+            && !complete)
             break;
 
-        for (j = i = cable->todo.next_item, n = 0; n < cable->todo.num_items;
-             n++)
+        for (j = i = todo->next_item, n = 0; n < todo->num_items; n++)
         {
 
-            switch (cable->todo.data[i].action)
+            switch (todo->data[i].action)
             {
             case URJ_TAP_CABLE_CLOCK:
             case URJ_TAP_CABLE_CLOCK_COMPACT:
                 {
-                    int tdi = cable->todo.data[i].arg.clock.tdi ? 1 << 7 : 0;
+                    int tdi = todo->data[i].arg.clock.tdi ? 1 << 7 : 0;
                     int length = 0;
                     uint8_t byte = 0;
                     int tms = 0;
                     int cn = 0;
 
-                    if (cable->todo.data[i].action == URJ_TAP_CABLE_CLOCK_COMPACT)
+                    if (todo->data[i].action == URJ_TAP_CABLE_CLOCK_COMPACT)
                     {
-                        length = cable->todo.data[i].arg.clock.n;
-                        byte = cable->todo.data[i].arg.clock.tms;
+                        length = todo->data[i].arg.clock.n;
+                        byte = todo->data[i].arg.clock.tms;
                     }
 
                   more_cable_clock:
 
-                    if (cable->todo.data[i].action == URJ_TAP_CABLE_CLOCK)
+                    if (todo->data[i].action == URJ_TAP_CABLE_CLOCK)
                     {
-                        tms = cable->todo.data[i].arg.clock.tms ? 1 : 0;
-                        cn = cable->todo.data[i].arg.clock.n;
+                        tms = todo->data[i].arg.clock.tms ? 1 : 0;
+                        cn = todo->data[i].arg.clock.n;
                     }
                     while (cn > 0)
                     {
@@ -2013,29 +2027,29 @@ ft2232_flush (urj_cable_t *cable, urj_cable_flush_amount_t how_much)
                             byte = 0;
                         }
                     }
-                    if (n + 1 < cable->todo.num_items
-                        && cable->todo.data[(i + 1) % cable->todo.max_items].action == URJ_TAP_CABLE_CLOCK
-                        && (cable->todo.data[(i + 1) % cable->todo.max_items].arg.clock.tdi ? 1 << 7 : 0) == tdi)
+                    if (n + 1 < todo->num_items
+                        && todo->data[(i + 1) % todo->max_items].action == URJ_TAP_CABLE_CLOCK
+                        && (todo->data[(i + 1) % todo->max_items].arg.clock.tdi ? 1 << 7 : 0) == tdi)
                     {
                         i++;
-                        if (i >= cable->todo.max_items)
+                        if (i >= todo->max_items)
                             i = 0;
                         n++;
                         goto more_cable_clock;
                     }
                     if (length)
                     {
-                        if (n + 1 < cable->todo.num_items
-                            || how_much == URJ_TAP_CABLE_COMPLETELY)
+                        if (n + 1 < todo->num_items || complete)
                             ft2232_clock_compact_schedule (cable, length - 1, byte | tdi);
                         else
                         {
-                            cable->todo.data[i].action = URJ_TAP_CABLE_CLOCK_COMPACT;
-                            cable->todo.data[i].arg.clock.tms = byte;
-                            cable->todo.data[i].arg.clock.n = length;
+                            todo->data[i].action = URJ_TAP_CABLE_CLOCK_COMPACT;
+                            todo->data[i].arg.clock.tms = byte;
+                            todo->data[i].arg.clock.n = length;
                             i--;
                             if (i == -1)
-                                i = cable->todo.max_items;
+                                i = todo->max_items;
+                            kept = 1;
                         }
                     }
 
@@ -2053,19 +2067,19 @@ ft2232_flush (urj_cable_t *cable, urj_cable_flush_amount_t how_much)
 
             case URJ_TAP_CABLE_SET_SIGNAL:
                 ft2232_set_signal_schedule (params,
-                                            cable->todo.data[i].arg.value.
+                                            todo->data[i].arg.value.
                                             mask,
-                                            cable->todo.data[i].arg.value.val,
+                                            todo->data[i].arg.value.val,
                                             1, 1);
                 last_tdo_valid_schedule = 0;
                 break;
 
             case URJ_TAP_CABLE_TRANSFER:
                 ft2232_transfer_schedule (cable,
-                                          cable->todo.data[i].arg.transfer.
+                                          todo->data[i].arg.transfer.
                                           len,
-                                          cable->todo.data[i].arg.transfer.in,
-                                          cable->todo.data[i].arg.transfer.
+                                          todo->data[i].arg.transfer.in,
+                                          todo->data[i].arg.transfer.
                                           out);
                 last_tdo_valid_schedule = params->last_tdo_valid;
                 break;
@@ -2075,26 +2089,28 @@ ft2232_flush (urj_cable_t *cable, urj_cable_flush_amount_t how_much)
             }
 
             i++;
-            if (i >= cable->todo.max_items)
+            if (i >= todo->max_items)
                 i = 0;
         }
 
         urj_tap_cable_cx_xfer (&params->cmd_root, &imm_cmd, cable,
                                how_much);
 
-        while (j != i)
+        /* count rather than compare j with i, which are equal as well
+           when the queue was completely full */
+        for (n -= kept; n > 0; n--)
         {
-            switch (cable->todo.data[j].action)
+            switch (todo->data[j].action)
             {
             case URJ_TAP_CABLE_CLOCK:
                 {
                     post_signals &=
                         ~(URJ_POD_CS_TCK | URJ_POD_CS_TDI | URJ_POD_CS_TMS);
                     post_signals |=
-                        (cable->todo.data[j].arg.clock.
+                        (todo->data[j].arg.clock.
                          tms ? URJ_POD_CS_TMS : 0);
                     post_signals |=
-                        (cable->todo.data[j].arg.clock.
+                        (todo->data[j].arg.clock.
                          tdi ? URJ_POD_CS_TDI : 0);
                     params->last_tdo_valid = last_tdo_valid_finish = 0;
                     break;
@@ -2104,11 +2120,11 @@ ft2232_flush (urj_cable_t *cable, urj_cable_flush_amount_t how_much)
                     post_signals &=
                         ~(URJ_POD_CS_TCK | URJ_POD_CS_TDI | URJ_POD_CS_TMS);
                     post_signals |=
-                        ((cable->todo.data[j].arg.clock.
-                          tms >> cable->todo.data[j].arg.clock.
+                        ((todo->data[j].arg.clock.
+                          tms >> todo->data[j].arg.clock.
                           n) ? URJ_POD_CS_TMS : 0);
                     post_signals |=
-                        (cable->todo.data[j].arg.clock.
+                        (todo->data[j].arg.clock.
                          tdi ? URJ_POD_CS_TDI : 0);
                     params->last_tdo_valid = last_tdo_valid_finish = 0;
                     break;
@@ -2122,64 +2138,67 @@ ft2232_flush (urj_cable_t *cable, urj_cable_flush_amount_t how_much)
                     else
                         tdo = ft2232_get_tdo_finish (cable);
                     last_tdo_valid_finish = params->last_tdo_valid;
-                    m = urj_tap_cable_add_queue_item (cable, &cable->done);
-                    cable->done.data[m].action = URJ_TAP_CABLE_GET_TDO;
-                    cable->done.data[m].arg.value.val = tdo;
+                    m = urj_tap_cable_add_queue_item (cable, done);
+                    done->data[m].action = URJ_TAP_CABLE_GET_TDO;
+                    done->data[m].arg.value.val = tdo;
                     break;
                 }
             case URJ_TAP_CABLE_SET_SIGNAL:
                 {
                     int m =
-                        urj_tap_cable_add_queue_item (cable, &cable->done);
-                    cable->done.data[m].action = URJ_TAP_CABLE_SET_SIGNAL;
-                    cable->done.data[m].arg.value.mask =
-                        cable->todo.data[j].arg.value.mask;
-                    cable->done.data[m].arg.value.val = post_signals;
+                        urj_tap_cable_add_queue_item (cable, done);
+                    done->data[m].action = URJ_TAP_CABLE_SET_SIGNAL;
+                    done->data[m].arg.value.mask =
+                        todo->data[j].arg.value.mask;
+                    done->data[m].arg.value.val = post_signals;
                     int mask =
-                        cable->todo.data[j].arg.value.
+                        todo->data[j].arg.value.
                         mask & ~(URJ_POD_CS_TCK | URJ_POD_CS_TDI |
                                  URJ_POD_CS_TMS | URJ_POD_CS_TRST |
                                  URJ_POD_CS_RESET);
                     post_signals =
-                        (post_signals & ~mask) | (cable->todo.data[j].arg.
+                        (post_signals & ~mask) | (todo->data[j].arg.
                                                   value.val & mask);
                 }
             case URJ_TAP_CABLE_GET_SIGNAL:
                 {
                     int m =
-                        urj_tap_cable_add_queue_item (cable, &cable->done);
-                    cable->done.data[m].action = URJ_TAP_CABLE_GET_SIGNAL;
-                    cable->done.data[m].arg.value.sig =
-                        cable->todo.data[j].arg.value.sig;
-                    cable->done.data[m].arg.value.val =
-                        (post_signals & cable->todo.data[j].arg.value.
+                        urj_tap_cable_add_queue_item (cable, done);
+                    done->data[m].action = URJ_TAP_CABLE_GET_SIGNAL;
+                    done->data[m].arg.value.sig =
+                        todo->data[j].arg.value.sig;
+                    done->data[m].arg.value.val =
+                        (post_signals & todo->data[j].arg.value.
                          sig) ? 1 : 0;
                     break;
                 }
             case URJ_TAP_CABLE_TRANSFER:
                 {
                     int r = ft2232_transfer_finish (cable,
-                                                    cable->todo.data[j].arg.
+                                                    todo->data[j].arg.
                                                     transfer.len,
-                                                    cable->todo.data[j].arg.
+                                                    todo->data[j].arg.
                                                     transfer.out);
                     last_tdo_valid_finish = params->last_tdo_valid;
-                    free (cable->todo.data[j].arg.transfer.in);
-                    if (cable->todo.data[j].arg.transfer.out)
+                    if (!todo->data[j].arg.transfer.borrowed)
+                        free (todo->data[j].arg.transfer.in);
+                    if (todo->data[j].arg.transfer.out)
                     {
                         int m = urj_tap_cable_add_queue_item (cable,
-                                                              &cable->done);
+                                                              done);
                         if (m < 0)
                         {
                             // retain error state
                             // urj_log (URJ_LOG_LEVEL_NORMAL, "out of memory!\n");
                         }
-                        cable->done.data[m].action = URJ_TAP_CABLE_TRANSFER;
-                        cable->done.data[m].arg.xferred.len =
-                            cable->todo.data[j].arg.transfer.len;
-                        cable->done.data[m].arg.xferred.res = r;
-                        cable->done.data[m].arg.xferred.out =
-                            cable->todo.data[j].arg.transfer.out;
+                        done->data[m].action = URJ_TAP_CABLE_TRANSFER;
+                        done->data[m].arg.xferred.len =
+                            todo->data[j].arg.transfer.len;
+                        done->data[m].arg.xferred.res = r;
+                        done->data[m].arg.xferred.out =
+                            todo->data[j].arg.transfer.out;
+                        done->data[m].arg.xferred.borrowed =
+                            todo->data[j].arg.transfer.borrowed;
                     }
                 }
             default:
@@ -2187,13 +2206,251 @@ ft2232_flush (urj_cable_t *cable, urj_cable_flush_amount_t how_much)
             }
 
             j++;
-            if (j >= cable->todo.max_items)
+            if (j >= todo->max_items)
                 j = 0;
-            cable->todo.num_items--;
+            todo->num_items--;
+        }
+
+        todo->next_item = i;
+    }
+}
+
+
+#ifdef HAVE_PTHREAD
+/* Optional flush thread, enabled with the cable parameter thread=1.
+   The caller keeps queueing deferred operations.  Every FT2232_BATCH_ITEMS
+   items the todo queue is handed over as one batch through a ring of
+   FT2232_BATCH_RING slots, and the worker encodes the batch and runs the
+   USB transfers.  Results stay with their batch until a flush that needs
+   them (TO_OUTPUT or COMPLETELY), which is the fence: it waits for all
+   batches and appends their results to cable->done in order.  While
+   batches are pending, params and the usbconn belong to the worker. */
+#define FT2232_BATCH_ITEMS      256
+#define FT2232_BATCH_RING       4
+
+typedef struct
+{
+    urj_cable_queue_info_t todo;
+    urj_cable_queue_info_t done;
+}
+ft2232_batch_t;
+
+struct ft2232_worker
+{
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;        /* batch submitted or stop requested */
+    pthread_cond_t idle;        /* batch finished */
+    ft2232_batch_t ring[FT2232_BATCH_RING];
+    int head;                   /* oldest batch not yet collected */
+    int submitted;              /* batches handed over and not collected */
+    int finished;               /* batches of those that are done */
+    int stop;
+};
+
+static void *
+ft2232_worker_main (void *arg)
+{
+    urj_cable_t *cable = arg;
+    params_t *params = cable->params;
+    ft2232_worker_t *w = params->worker;
+
+    pthread_mutex_lock (&w->lock);
+    for (;;)
+    {
+        ft2232_batch_t *b;
+
+        while (!w->stop && w->finished == w->submitted)
+            pthread_cond_wait (&w->wake, &w->lock);
+        if (w->finished == w->submitted)
+            break;
+        b = &w->ring[(w->head + w->finished) % FT2232_BATCH_RING];
+        pthread_mutex_unlock (&w->lock);
+
+        /* no partial clock byte is kept back, the next batch may not come */
+        ft2232_flush_queue (cable, &b->todo, &b->done,
+                            URJ_TAP_CABLE_TO_OUTPUT, 1);
+
+        pthread_mutex_lock (&w->lock);
+        w->finished++;
+        pthread_cond_signal (&w->idle);
+    }
+    pthread_mutex_unlock (&w->lock);
+
+    return NULL;
+}
+
+/* wait for the oldest batch and move its results to cable->done */
+static void
+ft2232_worker_collect (urj_cable_t *cable)
+{
+    params_t *params = cable->params;
+    ft2232_worker_t *w = params->worker;
+    ft2232_batch_t *b = &w->ring[w->head];
+
+    pthread_mutex_lock (&w->lock);
+    while (w->finished == 0)
+        pthread_cond_wait (&w->idle, &w->lock);
+    pthread_mutex_unlock (&w->lock);
+
+    while (b->done.num_items > 0)
+    {
+        int i = urj_tap_cable_get_queue_item (cable, &b->done);
+        int m = urj_tap_cable_add_queue_item (cable, &cable->done);
+
+        if (m < 0)
+        {
+            urj_tap_cable_purge_queue (&b->done, 1);
+            break;
+        }
+        cable->done.data[m] = b->done.data[i];
+    }
+    b->done.next_item = b->done.next_free = 0;
+
+    pthread_mutex_lock (&w->lock);
+    w->head = (w->head + 1) % FT2232_BATCH_RING;
+    w->submitted--;
+    w->finished--;
+    cable->pending = w->submitted;
+    pthread_mutex_unlock (&w->lock);
+}
+
+/* hand the todo queue over to the worker */
+static void
+ft2232_worker_submit (urj_cable_t *cable)
+{
+    params_t *params = cable->params;
+    ft2232_worker_t *w = params->worker;
+    urj_cable_queue_info_t q;
+    ft2232_batch_t *b;
+
+    if (w->submitted == FT2232_BATCH_RING)
+        ft2232_worker_collect (cable);
+
+    /* swap queue storage, the batch's todo queue is empty */
+    b = &w->ring[(w->head + w->submitted) % FT2232_BATCH_RING];
+    q = b->todo;
+    b->todo = cable->todo;
+    cable->todo = q;
+    cable->todo.num_items = cable->todo.next_item = cable->todo.next_free = 0;
+
+    pthread_mutex_lock (&w->lock);
+    w->submitted++;
+    cable->pending = w->submitted;
+    pthread_cond_signal (&w->wake);
+    pthread_mutex_unlock (&w->lock);
+}
+
+static void
+ft2232_worker_stop (urj_cable_t *cable)
+{
+    params_t *params = cable->params;
+    ft2232_worker_t *w = params->worker;
+    int k;
+
+    while (w->submitted > 0)
+        ft2232_worker_collect (cable);
+
+    pthread_mutex_lock (&w->lock);
+    w->stop = 1;
+    pthread_cond_signal (&w->wake);
+    pthread_mutex_unlock (&w->lock);
+    pthread_join (w->thread, NULL);
+
+    pthread_cond_destroy (&w->idle);
+    pthread_cond_destroy (&w->wake);
+    pthread_mutex_destroy (&w->lock);
+    for (k = 0; k < FT2232_BATCH_RING; k++)
+    {
+        free (w->ring[k].todo.data);
+        free (w->ring[k].done.data);
+    }
+    free (w);
+    params->worker = NULL;
+}
+
+static int
+ft2232_worker_start (urj_cable_t *cable)
+{
+    params_t *params = cable->params;
+    ft2232_worker_t *w;
+    int k;
+
+    w = calloc (1, sizeof (ft2232_worker_t));
+    if (!w)
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, _("calloc(%zd,%zd) fails"),
+                       (size_t) 1, sizeof (ft2232_worker_t));
+        return URJ_STATUS_FAIL;
+    }
+
+    for (k = 0; k < FT2232_BATCH_RING; k++)
+    {
+        w->ring[k].todo.max_items = w->ring[k].done.max_items = 128;
+        w->ring[k].todo.data = malloc (128 * sizeof (urj_cable_queue_t));
+        w->ring[k].done.data = malloc (128 * sizeof (urj_cable_queue_t));
+        if (!w->ring[k].todo.data || !w->ring[k].done.data)
+        {
+            urj_error_set (URJ_ERROR_OUT_OF_MEMORY, _("malloc(%zd) fails"),
+                           128 * sizeof (urj_cable_queue_t));
+            break;
+        }
+    }
+
+    pthread_mutex_init (&w->lock, NULL);
+    pthread_cond_init (&w->wake, NULL);
+    pthread_cond_init (&w->idle, NULL);
+    params->worker = w;
+
+    if (k < FT2232_BATCH_RING
+        || pthread_create (&w->thread, NULL, ft2232_worker_main, cable) != 0)
+    {
+        if (k == FT2232_BATCH_RING)
+            urj_error_set (URJ_ERROR_IO, _("pthread_create() failed"));
+        pthread_cond_destroy (&w->idle);
+        pthread_cond_destroy (&w->wake);
+        pthread_mutex_destroy (&w->lock);
+        for (k = 0; k < FT2232_BATCH_RING; k++)
+        {
+            free (w->ring[k].todo.data);
+            free (w->ring[k].done.data);
+        }
+        free (w);
+        params->worker = NULL;
+        return URJ_STATUS_FAIL;
+    }
+
+    return URJ_STATUS_OK;
+}
+#endif /* HAVE_PTHREAD */
+
+
+static void
+ft2232_flush (urj_cable_t *cable, urj_cable_flush_amount_t how_much)
+{
+#ifdef HAVE_PTHREAD
+    params_t *params = cable->params;
+
+    if (params->worker)
+    {
+        if (how_much == URJ_TAP_CABLE_OPTIONALLY)
+        {
+            if (cable->todo.num_items >= FT2232_BATCH_ITEMS)
+                ft2232_worker_submit (cable);
+            return;
         }
 
-        cable->todo.next_item = i;
+        /* fence: the rest is run here once the worker is idle */
+        while (params->worker->submitted > 0)
+            ft2232_worker_collect (cable);
     }
+#endif
+
+    if (how_much == URJ_TAP_CABLE_OPTIONALLY)
+        return;
+
+    ft2232_flush_queue (cable, &cable->todo, &cable->done, how_much,
+                        how_much == URJ_TAP_CABLE_COMPLETELY);
 }
 
 
@@ -2201,6 +2458,13 @@ static int
 ft2232_connect (urj_cable_t *cable, const urj_param_t *params[])
 {
     params_t *cable_params;
+    int thread = 0;
+    int i;
+
+    if (params != NULL)
+        for (i = 0; params[i] != NULL; i++)
+            if (params[i]->key == URJ_CABLE_PARAM_KEY_THREAD)
+                thread = params[i]->value.lu;
 
     /* perform urj_tap_cable_generic_usbconn_connect */
     if (urj_tap_cable_generic_usbconn_connect (cable, params) != URJ_STATUS_OK)
@@ -2229,6 +2493,20 @@ ft2232_connect (urj_cable_t *cable, const urj_param_t *params[])
     free (cable->params);
     cable->params = cable_params;
 
+#ifdef HAVE_PTHREAD
+    cable_params->worker = NULL;
+    if (thread && ft2232_worker_start (cable) != URJ_STATUS_OK)
+    {
+        urj_warning (_("%s, flushing without thread\n"),
+                     urj_error_describe ());
+        urj_error_reset ();
+    }
+#else
+    if (thread)
+        urj_warning (_("Built without thread support, ignoring thread=%d\n"),
+                     thread);
+#endif
+
     return URJ_STATUS_OK;
 }
 
@@ -2238,6 +2516,10 @@ ft2232_cable_free (urj_cable_t *cable)
 {
     params_t *params = cable->params;
 
+#ifdef HAVE_PTHREAD
+    if (params->worker)
+        ft2232_worker_stop (cable);
+#endif
     urj_tap_cable_cx_cmd_deinit (&params->cmd_root);
 
     urj_tap_cable_generic_usbconn_free (cable);
@@ -2247,8 +2529,12 @@ ft2232_cable_free (urj_cable_t *cable)
 void
 ftdx_usbcable_help (urj_log_level_t ll, const char *cablename)
 {
-    const char *ex_short = "[driver=DRIVER]";
-    const char *ex_desc = "DRIVER     usbconn driver, either ftdi-mpsse or ftd2xx-mpsse\n";
+    const char *ex_short = "[driver=DRIVER] [async=N] [thread=1]";
+    const char *ex_desc =
+        "DRIVER     usbconn driver, either ftdi-mpsse or ftd2xx-mpsse\n"
+        "N          USB writes kept in flight by ftdi-mpsse (default 0, libftdi\n"
+        "           with async mode only)\n"
+        "thread=1   encode and transfer queued operations in a separate thread\n";
     urj_tap_cable_generic_usbconn_help_ex (ll, cablename, ex_short, ex_desc);
 }
 
@@ -131,7 +131,8 @@ do_one_queued_action (urj_cable_t *cable)
                                                  cable->todo.data[i].arg.
                                                  transfer.out);
 
-                free (cable->todo.data[i].arg.transfer.in);
+                if (!cable->todo.data[i].arg.transfer.borrowed)
+                    free (cable->todo.data[i].arg.transfer.in);
                 if (cable->todo.data[i].arg.transfer.out != NULL)
                 {
                     /* @@@@ RFHH check result */
@@ -146,6 +147,8 @@ do_one_queued_action (urj_cable_t *cable)
                     cable->done.data[j].arg.xferred.res = r;
                     cable->done.data[j].arg.xferred.out =
                         cable->todo.data[i].arg.transfer.out;
+                    cable->done.data[j].arg.xferred.borrowed =
+                        cable->todo.data[i].arg.transfer.borrowed;
                 }
                 break;
             }
@@ -345,7 +348,8 @@ urj_tap_cable_generic_flush_using_transfer (urj_cable_t *cable,
                 {
                     char *p = cable->todo.data[i].arg.transfer.out;
                     int len = cable->todo.data[i].arg.transfer.len;
-                    free (cable->todo.data[i].arg.transfer.in);
+                    if (!cable->todo.data[i].arg.transfer.borrowed)
+                        free (cable->todo.data[i].arg.transfer.in);
                     if (p != NULL)
                     {
                         int c = urj_tap_cable_add_queue_item (cable,
@@ -357,6 +361,8 @@ urj_tap_cable_generic_flush_using_transfer (urj_cable_t *cable,
                         cable->done.data[c].arg.xferred.len = len;
                         cable->done.data[c].arg.xferred.res = r;
                         cable->done.data[c].arg.xferred.out = p;
+                        cable->done.data[c].arg.xferred.borrowed =
+                            cable->todo.data[i].arg.transfer.borrowed;
                         if (len > 0)
                             memcpy (p, out + bits, len);
                     }
@@ -1205,7 +1205,8 @@ static void adi_flush (urj_cable_t *cable, urj_cable_flush_amount_t how_much)
                 break;
             case URJ_TAP_CABLE_TRANSFER:
                 /* set up the get data */
-                free (todo_data->arg.transfer.in);
+                if (!todo_data->arg.transfer.borrowed)
+                    free (todo_data->arg.transfer.in);
                 todo_data->arg.transfer.in = NULL;
                 if ((todo_data->arg.transfer.out != NULL) && (tdo_ptr != NULL))
                 {
@@ -1218,6 +1219,7 @@ static void adi_flush (urj_cable_t *cable, urj_cable_flush_amount_t how_much)
                     done_data->arg.xferred.len = todo_data->arg.transfer.len;
                     done_data->arg.xferred.res = 0;
                     done_data->arg.xferred.out = todo_data->arg.transfer.out;
+                    done_data->arg.xferred.borrowed = todo_data->arg.transfer.borrowed;
                     tdo_idx++;
                     scan_out++;
                 }
@@ -113,14 +113,19 @@ jim_cable_init (urj_cable_t *cable)
 static void
 jim_cable_clock (urj_cable_t *cable, int tms, int tdi, int n)
 {
-    int i;
     jim_cable_params_t *jcp = cable->params;
 
-    for (i = 0; i < n; i++)
-    {
-        urj_jim_tck_rise (jcp->s, tms, tdi);
-        urj_jim_tck_fall (jcp->s);
-    }
+    urj_jim_clock (jcp->s, tms, tdi, n);
+}
+
+static int
+jim_cable_transfer (urj_cable_t *cable, int len, const char *in, char *out)
+{
+    jim_cable_params_t *jcp = cable->params;
+
+    urj_jim_transfer (jcp->s, len, in, out);
+
+    return len;
 }
 
 static int
@@ -168,7 +173,7 @@ const urj_cable_driver_t urj_tap_cable_jim_driver = {
     urj_tap_cable_generic_set_frequency,
     jim_cable_clock,
     jim_cable_get_tdo,
-    urj_tap_cable_generic_transfer,
+    jim_cable_transfer,
     jim_cable_set_trst,
     jim_cable_get_trst,
     urj_tap_cable_generic_flush_using_transfer,
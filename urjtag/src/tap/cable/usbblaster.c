@@ -463,7 +463,8 @@ usbblaster_flush (urj_cable_t *cable, urj_cable_flush_amount_t how_much)
                                                         arg.transfer.len,
                                                         cable->todo.data[j].
                                                         arg.transfer.out);
-                    free (cable->todo.data[j].arg.transfer.in);
+                    if (!cable->todo.data[j].arg.transfer.borrowed)
+                        free (cable->todo.data[j].arg.transfer.in);
                     if (cable->todo.data[j].arg.transfer.out)
                     {
                         int m = urj_tap_cable_add_queue_item (cable,
@@ -479,6 +480,8 @@ usbblaster_flush (urj_cable_t *cable, urj_cable_flush_amount_t how_much)
                         cable->done.data[m].arg.xferred.res = r;
                         cable->done.data[m].arg.xferred.out =
                             cable->todo.data[j].arg.transfer.out;
+                        cable->done.data[m].arg.xferred.borrowed =
+                            cable->todo.data[j].arg.transfer.borrowed;
                     }
                 }
             default:
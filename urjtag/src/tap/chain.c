@@ -28,6 +28,7 @@
 #include <string.h>
 
 #include <urjtag/cable.h>
+#include <urjtag/tap_register.h>
 #include <urjtag/part.h>
 #include <urjtag/part_instruction.h>
 #include <urjtag/tap_state.h>
@@ -53,6 +54,7 @@ urj_tap_chain_alloc (void)
     chain->parts = NULL;
     chain->total_instr_len = 0;
     chain->active_part = 0;
+    chain->burst = NULL;
     URJ_BSDL_GLOBS_INIT (chain->bsdl);
     urj_tap_state_init (chain);
 
@@ -71,6 +73,250 @@ urj_tap_chain_free (urj_chain_t *chain)
     free (chain);
 }
 
+/*
+ * Burst mode for bus block transfers: while recording, data register shifts
+ * are queued on the cable with private copies of the registers and nothing
+ * is flushed.  urj_tap_chain_burst_replay() collects all outputs with one
+ * flush, and the same sequence of shifts is then answered from the records
+ * without touching the cable.
+ */
+typedef struct
+{
+    urj_tap_register_t **in;    /* one per part */
+    urj_tap_register_t **out;   /* NULL without capture_output */
+    int capture_output;
+    int chain_exit;
+    int queued;                 /* the shifts are on the cable queue */
+}
+burst_shift_t;
+
+struct URJ_CHAIN_BURST
+{
+    int replay;
+    int failed;
+    int parts;                  /* number of parts when recording started */
+    int len;
+    int max;
+    int next;                   /* next shift to replay */
+    burst_shift_t *shift;
+};
+
+static void
+burst_free (urj_chain_burst_t *b)
+{
+    int i, k;
+
+    for (i = 0; i < b->len; i++)
+    {
+        for (k = 0; k < b->parts; k++)
+        {
+            urj_tap_register_free (b->shift[i].in[k]);
+            if (b->shift[i].out)
+                urj_tap_register_free (b->shift[i].out[k]);
+        }
+        free (b->shift[i].in);
+        free (b->shift[i].out);
+    }
+    free (b->shift);
+    free (b);
+}
+
+static int
+burst_record_shift (urj_chain_t *chain, int capture_output, int capture,
+                    int chain_exit)
+{
+    urj_chain_burst_t *b = chain->burst;
+    urj_parts_t *ps = chain->parts;
+    burst_shift_t *r;
+    int i;
+
+    if (b->len == b->max)
+    {
+        int max = b->max ? 2 * b->max : 64;
+        burst_shift_t *shift = realloc (b->shift, max * sizeof *shift);
+
+        if (shift == NULL)
+        {
+            urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "realloc(%s,%zd) fails",
+                           "b->shift", max * sizeof *shift);
+            b->failed = 1;
+            return URJ_STATUS_FAIL;
+        }
+        b->shift = shift;
+        b->max = max;
+    }
+
+    r = &b->shift[b->len];
+    r->queued = 0;
+    r->capture_output = capture_output;
+    r->chain_exit = chain_exit;
+    r->in = calloc (ps->len, sizeof *r->in);
+    r->out = capture_output ? calloc (ps->len, sizeof *r->out) : NULL;
+    if (r->in == NULL || (capture_output && r->out == NULL))
+    {
+        free (r->in);
+        free (r->out);
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "calloc(%d,%zd) fails",
+                       ps->len, sizeof *r->in);
+        b->failed = 1;
+        return URJ_STATUS_FAIL;
+    }
+    /* counted now, so that burst_free() also releases partial records */
+    b->len++;
+
+    for (i = 0; i < ps->len; i++)
+    {
+        urj_data_register_t *dr = ps->parts[i]->active_instruction->data_register;
+
+        r->in[i] = urj_tap_register_duplicate (dr->in);
+        if (r->in[i] == NULL)
+        {
+            b->failed = 1;
+            return URJ_STATUS_FAIL;
+        }
+        if (capture_output)
+        {
+            r->out[i] = urj_tap_register_alloc (dr->out->len);
+            if (r->out[i] == NULL)
+            {
+                b->failed = 1;
+                return URJ_STATUS_FAIL;
+            }
+        }
+    }
+
+    if (capture)
+        urj_tap_capture_dr (chain);
+
+    for (i = 0; i < ps->len; i++)
+        urj_tap_defer_shift_register_nocopy (chain, r->in[i],
+                capture_output ? r->out[i] : NULL,
+                (i + 1) == ps->len ? chain_exit : URJ_CHAIN_EXITMODE_SHIFT);
+    r->queued = 1;
+
+    return URJ_STATUS_OK;
+}
+
+static int
+burst_replay_shift (urj_chain_t *chain, int capture_output)
+{
+    urj_chain_burst_t *b = chain->burst;
+    urj_parts_t *ps = chain->parts;
+    burst_shift_t *r;
+    int i;
+
+    if (b->next >= b->len)
+    {
+        urj_error_set (URJ_ERROR_ILLEGAL_STATE,
+                       _("more data register shifts than recorded"));
+        b->failed = 1;
+        return URJ_STATUS_FAIL;
+    }
+    r = &b->shift[b->next++];
+
+    for (i = 0; i < ps->len; i++)
+    {
+        urj_data_register_t *dr = ps->parts[i]->active_instruction->data_register;
+
+        if (urj_tap_register_compare (r->in[i], dr->in) != 0)
+        {
+            urj_error_set (URJ_ERROR_ILLEGAL_STATE,
+                           _("data register shift differs from the recorded one"));
+            b->failed = 1;
+            return URJ_STATUS_FAIL;
+        }
+        if (capture_output && r->out)
+            memcpy (dr->out->data, r->out[i]->data, dr->out->len);
+    }
+
+    return URJ_STATUS_OK;
+}
+
+/* collect the outputs of the recorded shifts, this flushes the cable */
+static void
+burst_collect (urj_chain_t *chain)
+{
+    urj_chain_burst_t *b = chain->burst;
+    int i, k;
+
+    for (i = 0; i < b->len; i++)
+        if (b->shift[i].queued && b->shift[i].out)
+            for (k = 0; k < b->parts; k++)
+                urj_tap_shift_register_output (chain, b->shift[i].in[k],
+                        b->shift[i].out[k],
+                        (k + 1) == b->parts ? b->shift[i].chain_exit
+                            : URJ_CHAIN_EXITMODE_SHIFT);
+    urj_tap_chain_flush (chain);
+}
+
+int
+urj_tap_chain_burst_start (urj_chain_t *chain)
+{
+    if (!chain || !chain->parts)
+    {
+        urj_error_set (URJ_ERROR_NO_CHAIN, "no chain or no part");
+        return URJ_STATUS_FAIL;
+    }
+    if (chain->burst)
+    {
+        urj_error_set (URJ_ERROR_ALREADY, _("burst already active"));
+        return URJ_STATUS_FAIL;
+    }
+
+    chain->burst = calloc (1, sizeof (urj_chain_burst_t));
+    if (chain->burst == NULL)
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "calloc(%zd,%zd) fails",
+                       (size_t) 1, sizeof (urj_chain_burst_t));
+        return URJ_STATUS_FAIL;
+    }
+    chain->burst->parts = chain->parts->len;
+
+    return URJ_STATUS_OK;
+}
+
+int
+urj_tap_chain_burst_replay (urj_chain_t *chain)
+{
+    urj_chain_burst_t *b = chain->burst;
+
+    if (b == NULL || b->replay)
+    {
+        urj_error_set (URJ_ERROR_ILLEGAL_STATE, _("no burst being recorded"));
+        return URJ_STATUS_FAIL;
+    }
+
+    burst_collect (chain);
+    b->replay = 1;
+
+    return b->failed ? URJ_STATUS_FAIL : URJ_STATUS_OK;
+}
+
+int
+urj_tap_chain_burst_end (urj_chain_t *chain)
+{
+    urj_chain_burst_t *b = chain->burst;
+    int failed;
+
+    if (b == NULL)
+        return URJ_STATUS_OK;
+
+    if (!b->replay)
+        burst_collect (chain);
+    else if (!b->failed && b->next != b->len)
+    {
+        urj_error_set (URJ_ERROR_ILLEGAL_STATE,
+                       _("fewer data register shifts than recorded"));
+        b->failed = 1;
+    }
+
+    failed = b->failed;
+    chain->burst = NULL;
+    burst_free (b);
+
+    return failed ? URJ_STATUS_FAIL : URJ_STATUS_OK;
+}
+
 int
 urj_tap_chain_connect (urj_chain_t *chain, const char *drivername, char *params[])
 {
@@ -256,6 +502,14 @@ urj_tap_chain_shift_instructions_mode (urj_chain_t *chain,
         return URJ_STATUS_FAIL;
     }
 
+    if (chain->burst)
+    {
+        urj_error_set (URJ_ERROR_ILLEGAL_STATE,
+                       _("instruction shift during burst"));
+        chain->burst->failed = 1;
+        return URJ_STATUS_FAIL;
+    }
+
     ps = chain->parts;
 
     for (i = 0; i < ps->len; i++)
@@ -276,11 +530,17 @@ urj_tap_chain_shift_instructions_mode (urj_chain_t *chain,
 
     for (i = 0; i < ps->len; i++)
     {
-        urj_tap_defer_shift_register (chain,
-                ps->parts[i]->active_instruction->value,
-                capture_output ? ps->parts[i]->active_instruction->out
-                    : NULL,
-                (i + 1) == ps->len ? chain_exit : URJ_CHAIN_EXITMODE_SHIFT);
+        if (capture_output)
+            urj_tap_defer_shift_register_nocopy (chain,
+                    ps->parts[i]->active_instruction->value,
+                    ps->parts[i]->active_instruction->out,
+                    (i + 1) == ps->len ? chain_exit
+                        : URJ_CHAIN_EXITMODE_SHIFT);
+        else
+            urj_tap_defer_shift_register (chain,
+                    ps->parts[i]->active_instruction->value, NULL,
+                    (i + 1) == ps->len ? chain_exit
+                        : URJ_CHAIN_EXITMODE_SHIFT);
     }
 
     if (capture_output)
@@ -342,6 +602,23 @@ urj_tap_chain_shift_data_registers_mode (urj_chain_t *chain,
         }
     }
 
+    if (chain->burst)
+    {
+        if (chain->burst->failed)
+            return URJ_STATUS_FAIL;
+        if (ps->len != chain->burst->parts)
+        {
+            urj_error_set (URJ_ERROR_ILLEGAL_STATE,
+                           _("chain changed during burst"));
+            chain->burst->failed = 1;
+            return URJ_STATUS_FAIL;
+        }
+        if (chain->burst->replay)
+            return burst_replay_shift (chain, capture_output);
+        return burst_record_shift (chain, capture_output, capture,
+                                   chain_exit);
+    }
+
     if (capture)
         urj_tap_capture_dr (chain);
 
@@ -350,12 +627,20 @@ urj_tap_chain_shift_data_registers_mode (urj_chain_t *chain,
 
     for (i = 0; i < ps->len; i++)
     {
-        urj_tap_defer_shift_register (chain,
-                ps->parts[i]->active_instruction->data_register->in,
-                capture_output ?
-                    ps->parts[i]->active_instruction->data_register->out
-                    : NULL,
-                (i + 1) == ps->len ? chain_exit : URJ_CHAIN_EXITMODE_SHIFT);
+        /* outputs are collected below before anything can change the
+           registers, so the cable queue may use them in place */
+        if (capture_output)
+            urj_tap_defer_shift_register_nocopy (chain,
+                    ps->parts[i]->active_instruction->data_register->in,
+                    ps->parts[i]->active_instruction->data_register->out,
+                    (i + 1) == ps->len ? chain_exit
+                        : URJ_CHAIN_EXITMODE_SHIFT);
+        else
+            urj_tap_defer_shift_register (chain,
+                    ps->parts[i]->active_instruction->data_register->in,
+                    NULL,
+                    (i + 1) == ps->len ? chain_exit
+                        : URJ_CHAIN_EXITMODE_SHIFT);
     }
 
     if (capture_output)
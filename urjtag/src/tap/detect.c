@@ -30,6 +30,8 @@
 #include <ctype.h>
 #include <string.h>
 #include <errno.h>
+#include <sys/types.h>
+#include <sys/stat.h>
 
 #include <urjtag/cmd.h>
 
@@ -46,37 +48,117 @@
 #include <urjtag/parse.h>
 #include <urjtag/jtag.h>
 
-static int
-find_record (char *filename, urj_tap_register_t *key,
-             char **id_name, char **id_fullname)
+/*
+ * The MANUFACTURERS, PARTS and STEPPINGS files are loaded once into a hash
+ * table per file and kept for all later detects, on all chains. A file is
+ * reloaded when its modification time or size changes.
+ */
+#define DB_HASH_SIZE    64
+
+typedef struct db_record
 {
-    FILE *file;
-    urj_tap_register_t *tr;
-    int r = 0;
-    char *line = NULL;
-    size_t len;
+    struct db_record *next;
+    int len;                    /* number of bits in key */
+    uint64_t key;
+    char *name;
+    char *fullname;
+}
+db_record_t;
 
-    free (*id_name);
-    free (*id_fullname);
-    *id_name = *id_fullname = NULL;
+typedef struct db_file
+{
+    struct db_file *next;
+    char *filename;
+    time_t mtime;
+    off_t size;
+    db_record_t *hash[DB_HASH_SIZE];
+}
+db_file_t;
 
-    file = fopen (filename, FOPEN_R);
-    if (!file)
+static db_file_t *db_files;
+
+static unsigned int
+db_hash (int len, uint64_t key)
+{
+    return (unsigned int) ((key * 2654435761u) ^ len) % DB_HASH_SIZE;
+}
+
+static void
+db_file_clear (db_file_t *db)
+{
+    int i;
+
+    for (i = 0; i < DB_HASH_SIZE; i++)
+        while (db->hash[i])
+        {
+            db_record_t *r = db->hash[i];
+
+            db->hash[i] = r->next;
+            free (r->name);
+            free (r->fullname);
+            free (r);
+        }
+}
+
+/* add a record unless the file already has one for the key, the first
+ * line for a key wins */
+static int
+db_file_add (db_file_t *db, const char *bits, const char *name,
+             const char *fullname)
+{
+    db_record_t **pr;
+    db_record_t *r;
+    uint64_t key = 0;
+    int len = strlen (bits);
+    const char *b;
+
+    if (len > 64)
+        return URJ_STATUS_OK;
+    for (b = bits; *b; b++)
+        key = (key << 1) | (*b != '0');
+
+    for (pr = &db->hash[db_hash (len, key)]; *pr; pr = &(*pr)->next)
+        if ((*pr)->len == len && (*pr)->key == key)
+            return URJ_STATUS_OK;
+
+    r = malloc (sizeof (db_record_t));
+    if (r == NULL)
     {
-        urj_log (URJ_LOG_LEVEL_ERROR, _("Unable to open file '%s'\n"), filename);
-        urj_error_IO_set ("Unable to open file '%s'", filename);
-        return r;
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "malloc(%zd) fails",
+                       sizeof (db_record_t));
+        return URJ_STATUS_FAIL;
+    }
+    r->next = NULL;
+    r->len = len;
+    r->key = key;
+    r->name = strdup (name);
+    r->fullname = strdup (fullname);
+    if (r->name == NULL || r->fullname == NULL)
+    {
+        free (r->name);
+        free (r->fullname);
+        free (r);
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "strdup(%s) fails", name);
+        return URJ_STATUS_FAIL;
     }
+    *pr = r;
+
+    return URJ_STATUS_OK;
+}
 
-    tr = urj_tap_register_alloc (key->len);
+/* parse lines of the form <bits> <name> <fullname> [# comment] */
+static int
+db_file_read (db_file_t *db, FILE *file)
+{
+    char *line = NULL;
+    size_t len;
+    int result = URJ_STATUS_OK;
 
-    for (;;)
+    while (result == URJ_STATUS_OK && getline (&line, &len, file) != -1)
     {
         char *p;
         char *s;
-
-        if (getline (&line, &len, file) == -1)
-            break;
+        char *bits, *name;
 
         /* remove comment and nl from the line */
         p = strpbrk (line, "#\n");
@@ -108,15 +190,7 @@ find_record (char *filename, urj_tap_register_t *key,
             s++;
         if (*s)
             *s++ = '\0';
-
-        /* test field length */
-        if (strlen (p) != key->len)
-            continue;
-
-        /* match */
-        urj_tap_register_init (tr, p);
-        if (urj_tap_register_compare (tr, key))
-            continue;
+        bits = p;
 
         /* next field */
         p = s;
@@ -135,9 +209,7 @@ find_record (char *filename, urj_tap_register_t *key,
             s++;
         if (*s)
             *s++ = '\0';
-
-        /* copy name */
-        *id_name = strdup (p);
+        name = p;
 
         /* next field */
         p = s;
@@ -148,25 +220,108 @@ find_record (char *filename, urj_tap_register_t *key,
 
         /* line is empty? */
         if (!*p)
-        {
-            free (*id_name);
-            *id_name = NULL;
             continue;
-        }
-
-        /* copy fullname */
-        *id_fullname = strdup (p);
 
-        r = 1;
-        break;
+        result = db_file_add (db, bits, name, p);
     }
     free (line);
 
+    return result;
+}
+
+static db_file_t *
+db_file_get (const char *filename)
+{
+    db_file_t *db;
+    struct stat st;
+    FILE *file;
+
+    file = fopen (filename, FOPEN_R);
+    if (!file)
+    {
+        urj_log (URJ_LOG_LEVEL_ERROR, _("Unable to open file '%s'\n"), filename);
+        urj_error_IO_set ("Unable to open file '%s'", filename);
+        return NULL;
+    }
+    if (fstat (fileno (file), &st) != 0)
+        st.st_mtime = st.st_size = 0;
+
+    for (db = db_files; db; db = db->next)
+        if (strcmp (db->filename, filename) == 0)
+            break;
+
+    if (db && db->mtime == st.st_mtime && db->size == st.st_size
+        && st.st_mtime != 0)
+    {
+        fclose (file);
+        return db;
+    }
+
+    if (db == NULL)
+    {
+        db = calloc (1, sizeof (db_file_t));
+        if (db == NULL || (db->filename = strdup (filename)) == NULL)
+        {
+            free (db);
+            fclose (file);
+            urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "calloc(%zd,%zd) fails",
+                           (size_t) 1, sizeof (db_file_t));
+            return NULL;
+        }
+        db->next = db_files;
+        db_files = db;
+    }
+    else
+        db_file_clear (db);
+
+    db->mtime = st.st_mtime;
+    db->size = st.st_size;
+    if (db_file_read (db, file) != URJ_STATUS_OK)
+    {
+        /* don't keep a partial index */
+        db_file_clear (db);
+        db->mtime = 0;
+        fclose (file);
+        return NULL;
+    }
     fclose (file);
 
-    urj_tap_register_free (tr);
+    return db;
+}
+
+static int
+find_record (char *filename, urj_tap_register_t *key,
+             char **id_name, char **id_fullname)
+{
+    db_file_t *db;
+    db_record_t *r;
+    uint64_t k;
+
+    free (*id_name);
+    free (*id_fullname);
+    *id_name = *id_fullname = NULL;
+
+    db = db_file_get (filename);
+    if (!db || key->len > 64)
+        return 0;
+
+    k = urj_tap_register_get_value (key);
+    for (r = db->hash[db_hash (key->len, k)]; r; r = r->next)
+        if (r->len == key->len && r->key == k)
+        {
+            *id_name = strdup (r->name);
+            *id_fullname = strdup (r->fullname);
+            if (*id_name == NULL || *id_fullname == NULL)
+            {
+                free (*id_name);
+                free (*id_fullname);
+                *id_name = *id_fullname = NULL;
+                return 0;
+            }
+            return 1;
+        }
 
-    return r;
+    return 0;
 }
 
 #define strncat_const(dst, src) strncat(dst, src, sizeof(dst) - strlen(dst) - 1)
@@ -325,8 +325,6 @@ int
 urj_tap_register_compare (const urj_tap_register_t *tr,
                           const urj_tap_register_t *tr2)
 {
-    int i;
-
     if (!tr && !tr2)
         return 0;
 
@@ -336,11 +334,7 @@ urj_tap_register_compare (const urj_tap_register_t *tr,
     if (tr->len != tr2->len)
         return 1;
 
-    for (i = 0; i < tr->len; i++)
-        if (tr->data[i] != tr2->data[i])
-            return 1;
-
-    return 0;
+    return memcmp (tr->data, tr2->data, tr->len) != 0;
 }
 
 int
@@ -442,3 +436,305 @@ urj_tap_register_shift_left (urj_tap_register_t *tr, int shift)
 
     return tr;
 }
+
+/* mask of the valid bits in the last word of a packed vector */
+static uint64_t
+packed_last_mask (int len)
+{
+    return (len % 64) ? (((uint64_t) 1 << (len % 64)) - 1) : ~(uint64_t) 0;
+}
+
+urj_tap_packed_t *
+urj_tap_packed_alloc (int len)
+{
+    urj_tap_packed_t *tp;
+    size_t words;
+
+    if (len < 1)
+    {
+        urj_error_set (URJ_ERROR_INVALID, "len < 1");
+        return NULL;
+    }
+
+    tp = malloc (sizeof (urj_tap_packed_t));
+    if (!tp)
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "malloc(%zd) fails",
+                       sizeof (urj_tap_packed_t));
+        return NULL;
+    }
+
+    words = URJ_TAP_PACKED_WORDS (len);
+    tp->data = calloc (words, sizeof (uint64_t));
+    if (!tp->data)
+    {
+        free (tp);
+        urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "calloc(%zd,%zd) fails",
+                       words, sizeof (uint64_t));
+        return NULL;
+    }
+
+    tp->len = len;
+
+    return tp;
+}
+
+void
+urj_tap_packed_free (urj_tap_packed_t *tp)
+{
+    if (tp)
+        free (tp->data);
+    free (tp);
+}
+
+urj_tap_packed_t *
+urj_tap_packed_fill (urj_tap_packed_t *tp, int val)
+{
+    int words;
+
+    if (!tp)
+        return NULL;
+
+    words = URJ_TAP_PACKED_WORDS (tp->len);
+    memset (tp->data, (val & 1) ? 0xff : 0, words * sizeof (uint64_t));
+    tp->data[words - 1] &= packed_last_mask (tp->len);
+
+    return tp;
+}
+
+void
+urj_tap_packed_set_bit (urj_tap_packed_t *tp, int n, int val)
+{
+    uint64_t b = (uint64_t) 1 << (n % 64);
+
+    if (val & 1)
+        tp->data[n / 64] |= b;
+    else
+        tp->data[n / 64] &= ~b;
+}
+
+int
+urj_tap_packed_set_value (urj_tap_packed_t *tp, uint64_t val)
+{
+    if (!tp)
+    {
+        urj_error_set (URJ_ERROR_INVALID, "tp == NULL");
+        return URJ_STATUS_FAIL;
+    }
+
+    if (tp->len < 64 && (val >> tp->len) != 0)
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_BOUNDS,
+                       _("value 0x%" PRIX64 " will not fit in %d bits"),
+                       val, tp->len);
+        return URJ_STATUS_FAIL;
+    }
+
+    memset (tp->data, 0, URJ_TAP_PACKED_WORDS (tp->len) * sizeof (uint64_t));
+    tp->data[0] = val;
+
+    return URJ_STATUS_OK;
+}
+
+uint64_t
+urj_tap_packed_get_value (const urj_tap_packed_t *tp)
+{
+    if (!tp)
+        return 0;
+
+    return tp->data[0];
+}
+
+int
+urj_tap_packed_compare (const urj_tap_packed_t *tp,
+                        const urj_tap_packed_t *tp2)
+{
+    if (!tp && !tp2)
+        return 0;
+
+    if (!tp || !tp2)
+        return 1;
+
+    if (tp->len != tp2->len)
+        return 1;
+
+    return memcmp (tp->data, tp2->data,
+                   URJ_TAP_PACKED_WORDS (tp->len) * sizeof (uint64_t)) != 0;
+}
+
+int
+urj_tap_packed_compare_masked (const urj_tap_packed_t *tp,
+                               const urj_tap_packed_t *tp2,
+                               const urj_tap_packed_t *mask)
+{
+    int i;
+
+    if (!mask)
+        return urj_tap_packed_compare (tp, tp2);
+
+    if (!tp || !tp2 || tp->len != tp2->len || tp->len != mask->len)
+        return 1;
+
+    for (i = 0; i < URJ_TAP_PACKED_WORDS (tp->len); i++)
+        if ((tp->data[i] ^ tp2->data[i]) & mask->data[i])
+            return 1;
+
+    return 0;
+}
+
+urj_tap_packed_t *
+urj_tap_packed_inc (urj_tap_packed_t *tp)
+{
+    int i, words;
+
+    if (!tp)
+        return NULL;
+
+    words = URJ_TAP_PACKED_WORDS (tp->len);
+    for (i = 0; i < words; i++)
+        if (++tp->data[i] != 0)
+            break;
+    tp->data[words - 1] &= packed_last_mask (tp->len);
+
+    return tp;
+}
+
+urj_tap_packed_t *
+urj_tap_packed_shift_right (urj_tap_packed_t *tp, int shift)
+{
+    int i, words, ws, bs;
+
+    if (!tp)
+        return NULL;
+
+    if (shift < 1)
+        return tp;
+
+    words = URJ_TAP_PACKED_WORDS (tp->len);
+    ws = shift / 64;
+    bs = shift % 64;
+
+    for (i = 0; i < words; i++)
+    {
+        uint64_t w = 0;
+
+        if (i + ws < words)
+        {
+            w = tp->data[i + ws] >> bs;
+            if (bs && i + ws + 1 < words)
+                w |= tp->data[i + ws + 1] << (64 - bs);
+        }
+        tp->data[i] = w;
+    }
+
+    return tp;
+}
+
+urj_tap_packed_t *
+urj_tap_packed_shift_left (urj_tap_packed_t *tp, int shift)
+{
+    int i, words, ws, bs;
+
+    if (!tp)
+        return NULL;
+
+    if (shift < 1)
+        return tp;
+
+    words = URJ_TAP_PACKED_WORDS (tp->len);
+    ws = shift / 64;
+    bs = shift % 64;
+
+    for (i = words - 1; i >= 0; i--)
+    {
+        uint64_t w = 0;
+
+        if (i - ws >= 0)
+        {
+            w = tp->data[i - ws] << bs;
+            if (bs && i - ws - 1 >= 0)
+                w |= tp->data[i - ws - 1] >> (64 - bs);
+        }
+        tp->data[i] = w;
+    }
+    tp->data[words - 1] &= packed_last_mask (tp->len);
+
+    return tp;
+}
+
+void
+urj_tap_packed_from_bits (urj_tap_packed_t *tp, const char *bits)
+{
+    int i, n;
+
+    for (i = 0; i < URJ_TAP_PACKED_WORDS (tp->len); i++)
+    {
+        uint64_t w = 0;
+        int last = (tp->len - i * 64 < 64) ? tp->len - i * 64 : 64;
+
+        for (n = last - 1; n >= 0; n--)
+            w = (w << 1) | (bits[i * 64 + n] & 1);
+        tp->data[i] = w;
+    }
+}
+
+void
+urj_tap_packed_to_bits (const urj_tap_packed_t *tp, char *bits)
+{
+    int i, n;
+
+    for (i = 0; i < URJ_TAP_PACKED_WORDS (tp->len); i++)
+    {
+        uint64_t w = tp->data[i];
+        int last = (tp->len - i * 64 < 64) ? tp->len - i * 64 : 64;
+
+        for (n = 0; n < last; n++, w >>= 1)
+            bits[i * 64 + n] = w & 1;
+    }
+}
+
+int
+urj_tap_packed_from_register (urj_tap_packed_t *tp,
+                              const urj_tap_register_t *tr)
+{
+    if (!tp || !tr)
+    {
+        urj_error_set (URJ_ERROR_INVALID, "tp or tr == NULL");
+        return URJ_STATUS_FAIL;
+    }
+
+    if (tp->len != tr->len)
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_BOUNDS,
+                       _("register length %d mismatch: %d"),
+                       tp->len, tr->len);
+        return URJ_STATUS_FAIL;
+    }
+
+    urj_tap_packed_from_bits (tp, tr->data);
+
+    return URJ_STATUS_OK;
+}
+
+int
+urj_tap_register_from_packed (urj_tap_register_t *tr,
+                              const urj_tap_packed_t *tp)
+{
+    if (!tp || !tr)
+    {
+        urj_error_set (URJ_ERROR_INVALID, "tp or tr == NULL");
+        return URJ_STATUS_FAIL;
+    }
+
+    if (tp->len != tr->len)
+    {
+        urj_error_set (URJ_ERROR_OUT_OF_BOUNDS,
+                       _("register length %d mismatch: %d"),
+                       tr->len, tp->len);
+        return URJ_STATUS_FAIL;
+    }
+
+    urj_tap_packed_to_bits (tp, tr->data);
+
+    return URJ_STATUS_OK;
+}
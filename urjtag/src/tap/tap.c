@@ -76,10 +76,9 @@ urj_tap_reset_bypass (urj_chain_t *chain)
     return URJ_STATUS_OK;
 }
 
-void
-urj_tap_defer_shift_register (urj_chain_t *chain,
-                              const urj_tap_register_t *in,
-                              urj_tap_register_t *out, int tap_exit)
+static void
+tap_defer_shift_register (urj_chain_t *chain, const urj_tap_register_t *in,
+                          urj_tap_register_t *out, int tap_exit, int nocopy)
 {
     int i;
 
@@ -97,7 +96,10 @@ urj_tap_defer_shift_register (urj_chain_t *chain,
     if (out && out->len < i)
         i = out->len;
 
-    if (out)
+    if (nocopy)
+        urj_tap_cable_defer_transfer_nocopy (chain->cable, i, in->data,
+                                             out ? out->data : NULL);
+    else if (out)
         urj_tap_cable_defer_transfer (chain->cable, i, in->data, out->data);
     else
         urj_tap_cable_defer_transfer (chain->cable, i, in->data, NULL);
@@ -120,6 +122,22 @@ urj_tap_defer_shift_register (urj_chain_t *chain,
         urj_tap_chain_defer_clock (chain, 1, 0, 1);     /* Update-DR or Update-IR */
 }
 
+void
+urj_tap_defer_shift_register (urj_chain_t *chain,
+                              const urj_tap_register_t *in,
+                              urj_tap_register_t *out, int tap_exit)
+{
+    tap_defer_shift_register (chain, in, out, tap_exit, 0);
+}
+
+void
+urj_tap_defer_shift_register_nocopy (urj_chain_t *chain,
+                                     const urj_tap_register_t *in,
+                                     urj_tap_register_t *out, int tap_exit)
+{
+    tap_defer_shift_register (chain, in, out, tap_exit, 1);
+}
+
 void
 urj_tap_shift_register_output (urj_chain_t *chain,
                                const urj_tap_register_t *in,
@@ -148,7 +166,9 @@ void
 urj_tap_shift_register (urj_chain_t *chain, const urj_tap_register_t *in,
                         urj_tap_register_t *out, int tap_exit)
 {
-    urj_tap_defer_shift_register (chain, in, out, tap_exit);
+    /* the output is collected right away, so the queue may use in and
+     * out directly; without out nobody waits for the transfer */
+    tap_defer_shift_register (chain, in, out, tap_exit, out != NULL);
     urj_tap_shift_register_output (chain, in, out, tap_exit);
 }
 
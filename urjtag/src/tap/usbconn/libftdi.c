@@ -45,6 +45,191 @@ static void usbconn_ftdi_free (urj_usbconn_t *conn);
 
 /* ---------------------------------------------------------------------- */
 
+/** make room for p->to_recv bytes; @return URJ_STATUS_OK on success */
+static int
+usbconn_ftdi_recv_prepare (ftdi_param_t *p)
+{
+    if (p->recv_write_idx + p->to_recv > p->recv_buf_len)
+    {
+        /* extend receive buffer */
+        p->recv_buf_len = p->recv_write_idx + p->to_recv;
+        if (p->recv_buf)
+            p->recv_buf = realloc (p->recv_buf, p->recv_buf_len);
+    }
+
+    if (!p->recv_buf)
+    {
+        urj_error_set (URJ_ERROR_ILLEGAL_STATE,
+                       _("Receive buffer does not exist"));
+        return URJ_STATUS_FAIL;
+    }
+
+    return URJ_STATUS_OK;
+}
+
+#ifdef HAVE_LIBFTDI_ASYNC_MODE
+/* ---------------------------------------------------------------------- */
+
+/* With async=N (N > 0) a flushed send buffer is handed over to one of N
+   slots and submitted with ftdi_write_data_submit() without waiting for
+   its completion.  The cable driver fills the next send buffer while the
+   previous ones are still on the wire, so up to N bulk OUT transfers are
+   queued at the device and the submission of commands overlaps with the
+   reception of the replies.  Completions are collected when a slot is
+   needed again and whenever data is read back. */
+
+typedef struct ftdi_async_slot
+{
+    uint8_t *buf;
+    uint32_t buf_len;
+    uint32_t len;
+    struct ftdi_transfer_control *tc;
+} ftdi_async_slot_t;
+
+/** wait for the oldest write in flight; @return URJ_STATUS_OK on success */
+static int
+usbconn_ftdi_async_wait (ftdi_param_t *p)
+{
+    ftdi_async_slot_t *s = &p->async[p->async_head];
+    int xferred;
+
+    xferred = ftdi_transfer_data_done (s->tc);
+    s->tc = NULL;
+    p->async_head = (p->async_head + 1) % p->async_depth;
+    p->async_count--;
+
+    if (xferred < 0)
+    {
+        urj_error_set (URJ_ERROR_FTD, "%s", ftdi_get_error_string (p->fc));
+        return URJ_STATUS_FAIL;
+    }
+
+    if (xferred < s->len)
+    {
+        urj_error_set (URJ_ERROR_FTD, _("Written fewer bytes than requested."));
+        return URJ_STATUS_FAIL;
+    }
+
+    return URJ_STATUS_OK;
+}
+
+/** wait for all writes in flight; @return URJ_STATUS_OK on success */
+static int
+usbconn_ftdi_async_drain (ftdi_param_t *p)
+{
+    int r = URJ_STATUS_OK;
+
+    while (p->async_count > 0)
+        if (usbconn_ftdi_async_wait (p) != URJ_STATUS_OK)
+            r = URJ_STATUS_FAIL;
+
+    return r;
+}
+
+/** submit the send buffer; @return URJ_STATUS_OK on success */
+static int
+usbconn_ftdi_async_submit (ftdi_param_t *p)
+{
+    ftdi_async_slot_t *s;
+    uint8_t *buf;
+    uint32_t buf_len;
+
+    if (p->async_count == p->async_depth)
+        if (usbconn_ftdi_async_wait (p) != URJ_STATUS_OK)
+            return URJ_STATUS_FAIL;
+
+    s = &p->async[(p->async_head + p->async_count) % p->async_depth];
+    if (!s->buf)
+    {
+        s->buf_len = p->send_buf_len;
+        s->buf = malloc (s->buf_len);
+        if (!s->buf)
+        {
+            urj_error_set (URJ_ERROR_OUT_OF_MEMORY, _("malloc(%zd) fails"),
+                           (size_t) s->buf_len);
+            return URJ_STATUS_FAIL;
+        }
+    }
+
+    /* the slot keeps the data until the transfer is done, continue
+       buffering in the slot's previous buffer */
+    buf = s->buf;
+    buf_len = s->buf_len;
+    s->buf = p->send_buf;
+    s->buf_len = p->send_buf_len;
+    s->len = p->send_buffered;
+    p->send_buf = buf;
+    p->send_buf_len = buf_len;
+    p->send_buffered = 0;
+
+    if ((s->tc = ftdi_write_data_submit (p->fc, s->buf, s->len)) == NULL)
+    {
+        urj_error_set (URJ_ERROR_FTD,
+                       _("Error from ftdi_write_data_submit(): %s"),
+                       ftdi_get_error_string (p->fc));
+        return URJ_STATUS_FAIL;
+    }
+    p->async_count++;
+
+    return URJ_STATUS_OK;
+}
+
+/** @return number of bytes flushed; -1 on error */
+static int
+usbconn_ftdi_flush_async (ftdi_param_t *p)
+{
+    struct ftdi_transfer_control *tc = NULL;
+    int xferred = p->send_buffered;
+    int recvd;
+
+    if (p->to_recv)
+    {
+        if (usbconn_ftdi_recv_prepare (p) != URJ_STATUS_OK)
+            return -1;
+
+        if ((tc = ftdi_read_data_submit (p->fc,
+                                         &(p->recv_buf[p->recv_write_idx]),
+                                         p->to_recv)) == NULL)
+        {
+            urj_error_set (URJ_ERROR_FTD,
+                           _("Error from ftdi_read_data_submit(): %s"),
+                           ftdi_get_error_string (p->fc));
+            return -1;
+        }
+    }
+
+    if (usbconn_ftdi_async_submit (p) != URJ_STATUS_OK)
+        return -1;
+
+    if (tc)
+    {
+        if ((recvd = ftdi_transfer_data_done (tc)) < 0)
+        {
+            urj_error_set (URJ_ERROR_FTD,
+                           _("Error from ftdi_transfer_data_done(): %s"),
+                           ftdi_get_error_string (p->fc));
+            return -1;
+        }
+
+        /* the device has answered, so all writes up to here are done */
+        if (usbconn_ftdi_async_drain (p) != URJ_STATUS_OK)
+            return -1;
+
+        if (recvd < p->to_recv)
+            urj_log (URJ_LOG_LEVEL_NORMAL,
+                     _("%s(): Received fewer bytes than requested.\n"),
+                     __func__);
+
+        p->to_recv -= recvd;
+        p->recv_write_idx += recvd;
+    }
+
+    return xferred;
+}
+#endif
+
+/* ---------------------------------------------------------------------- */
+
 /** @return number of bytes flushed; -1 on error */
 static int
 usbconn_ftdi_flush (ftdi_param_t *p)
@@ -61,7 +246,10 @@ usbconn_ftdi_flush (ftdi_param_t *p)
     if (p->send_buffered == 0)
         return 0;
 
-#ifndef HAVE_LIBFTDI_ASYNC_MODE
+#ifdef HAVE_LIBFTDI_ASYNC_MODE
+    if (p->async_depth > 0)
+        return usbconn_ftdi_flush_async (p);
+#else
     if ((xferred = ftdi_write_data (p->fc, p->send_buf, p->send_buffered)) < 0)
         urj_error_set (URJ_ERROR_FTD, _("ftdi_write_data() failed: %s"),
                        ftdi_get_error_string (p->fc));
@@ -79,20 +267,8 @@ usbconn_ftdi_flush (ftdi_param_t *p)
     /* now read all scheduled receive bytes */
     if (p->to_recv)
     {
-        if (p->recv_write_idx + p->to_recv > p->recv_buf_len)
-        {
-            /* extend receive buffer */
-            p->recv_buf_len = p->recv_write_idx + p->to_recv;
-            if (p->recv_buf)
-                p->recv_buf = realloc (p->recv_buf, p->recv_buf_len);
-        }
-
-        if (!p->recv_buf)
-        {
-            urj_error_set (URJ_ERROR_ILLEGAL_STATE,
-                           _("Receive buffer does not exist"));
+        if (usbconn_ftdi_recv_prepare (p) != URJ_STATUS_OK)
             return -1;
-        }
 
 #ifdef HAVE_LIBFTDI_ASYNC_MODE
         if ((tc = ftdi_read_data_submit (p->fc,
@@ -159,6 +335,12 @@ usbconn_ftdi_read (urj_usbconn_t *conn, uint8_t *buf, int len)
     if (usbconn_ftdi_flush (p) < 0)
         return -1;
 
+#ifdef HAVE_LIBFTDI_ASYNC_MODE
+    /* reading back is a synchronisation point for the writes in flight */
+    if (usbconn_ftdi_async_drain (p) != URJ_STATUS_OK)
+        return -1;
+#endif
+
     if (len == 0)
         return 0;
 
@@ -256,6 +438,13 @@ usbconn_ftdi_connect (urj_usbconn_cable_t *template,
     urj_usbconn_t *c = malloc (sizeof (urj_usbconn_t));
     ftdi_param_t *p = malloc (sizeof (ftdi_param_t));
     struct ftdi_context *fc = malloc (sizeof (struct ftdi_context));
+    unsigned int async_depth = 0;
+    int i;
+
+    if (params != NULL)
+        for (i = 0; params[i] != NULL; i++)
+            if (params[i]->key == URJ_CABLE_PARAM_KEY_ASYNC)
+                async_depth = params[i]->value.lu;
 
     if (p)
     {
@@ -289,6 +478,33 @@ usbconn_ftdi_connect (urj_usbconn_cable_t *template,
         return NULL;
     }
 
+#ifdef HAVE_LIBFTDI_ASYNC_MODE
+    p->async_depth = 0;
+    p->async_head = 0;
+    p->async_count = 0;
+    p->async = NULL;
+    if (async_depth > 0)
+    {
+        p->async = calloc (async_depth, sizeof (ftdi_async_slot_t));
+        if (!p->async)
+        {
+            free (p->send_buf);
+            free (p->recv_buf);
+            free (p);
+            free (c);
+            free (fc);
+            urj_error_set (URJ_ERROR_OUT_OF_MEMORY, "calloc(%u,%zd) failed",
+                           async_depth, sizeof (ftdi_async_slot_t));
+            return NULL;
+        }
+        p->async_depth = async_depth;
+    }
+#else
+    if (async_depth > 0)
+        urj_warning (_("libftdi without async mode, ignoring async=%u\n"),
+                     async_depth);
+#endif
+
     ftdi_init (fc);
     p->fc = fc;
     p->pid = template->pid;
@@ -604,6 +820,9 @@ usbconn_ftdi_close (urj_usbconn_t *conn)
 
     if (p->fc)
     {
+#ifdef HAVE_LIBFTDI_ASYNC_MODE
+        usbconn_ftdi_async_drain (p);
+#endif
         ftdi_usb_close (p->fc);
         ftdi_deinit (p->fc);
         p->fc = NULL;
@@ -627,6 +846,16 @@ usbconn_ftdi_free (urj_usbconn_t *conn)
         free (p->fc);
     if (p->serial)
         free (p->serial);
+#ifdef HAVE_LIBFTDI_ASYNC_MODE
+    if (p->async)
+    {
+        unsigned int i;
+
+        for (i = 0; i < p->async_depth; i++)
+            free (p->async[i].buf);
+        free (p->async);
+    }
+#endif
 
     free (conn->params);
     free (conn);
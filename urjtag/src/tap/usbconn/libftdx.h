@@ -75,6 +75,13 @@ typedef struct
     uint32_t recv_write_idx;
     uint32_t recv_read_idx;
     uint8_t *recv_buf;
+#ifdef HAVE_LIBFTDI_ASYNC_MODE
+    /* bulk OUT transfers in flight, see libftdi.c */
+    unsigned int async_depth;
+    unsigned int async_head;
+    unsigned int async_count;
+    struct ftdi_async_slot *async;
+#endif
 } ftdi_param_t;
 
 void ftdx_usbcable_help (urj_log_level_t ll, const char *cablename);